@@ -176,6 +176,12 @@ void gendlopen::create_template_lists(vtemplate_t &header, vtemplate_t &body)
         concat_sources(t::ptr_plugin_header, t::ptr_plugin_body);
         break;
 
+    case output::context:
+        load_template(t::file_ctx_header);
+        load_template(t::file_ctx_body);
+        concat_sources(t::ptr_ctx_header, t::ptr_ctx_body);
+        break;
+
     case output::minimal:
         load_template(t::file_min_c_header);
         header.push_back(t::ptr_min_c_header);
@@ -65,7 +65,7 @@ static void dump(FILE *fpOut, const char *in_dir, const char *in_file, const cha
 
     /* write output */
     fprintf(fpOut, "/* %s */\n", in_file);
-    fprintf(fpOut, "static const template_t %s[] = {\n", varName);
+    fprintf(fpOut, "static const raw_template_t %s_raw[] = {\n", varName);
 
     /* don't add line directive to license part */
     if (strcmp("license.h", in_file) != 0) {
@@ -154,9 +154,10 @@ static void dump(FILE *fpOut, const char *in_dir, const char *in_file, const cha
         fprintf(fpOut, "\", %s, %zd },\n", true_false[percent], count);
     }
 
-    fprintf(fpOut, "%s", "  { {}, 0, 0 }\n");
+    fprintf(fpOut, "%s", "  { NULL, false, 0 }\n");
     fprintf(fpOut, "%s", "};\n");
-    fprintf(fpOut, "const template_t *ptr_%s = %s;\n\n", varName, varName);
+    fprintf(fpOut, "static const std::vector<template_t> %s = convert(%s_raw);\n", varName, varName);
+    fprintf(fpOut, "const template_t *ptr_%s = %s.data();\n\n", varName, varName);
 
     fclose(fp);
 }
@@ -181,10 +182,33 @@ int main(int argc, char **argv)
     fprintf(fp, "%s\n",
         "/* this file was automatically generated; do not edit! */\n"
         "\n"
+        "#include <vector>\n"
         "#include \"types.hpp\"\n"
         "\n"
         "namespace templates\n"
-        "{\n");
+        "{\n"
+        "\n"
+        "/* Template lines are saved as plain data and converted on startup;\n"
+        " * a static initializer with thousands of std::string objects takes\n"
+        " * a lot of time and memory to compile. */\n"
+        "typedef struct {\n"
+        "    const char *data;\n"
+        "    bool maybe_keyword;\n"
+        "    size_t line_count;\n"
+        "} raw_template_t;\n"
+        "\n"
+        "static std::vector<template_t> convert(const raw_template_t *raw)\n"
+        "{\n"
+        "    std::vector<template_t> v;\n"
+        "\n"
+        "    for ( ; raw->data != NULL; raw++) {\n"
+        "        v.push_back({ raw->data, raw->maybe_keyword, raw->line_count });\n"
+        "    }\n"
+        "\n"
+        "    v.push_back({ {}, false, 0 });\n"
+        "\n"
+        "    return v;\n"
+        "}\n");
 
 #define TEMPLATE(FILE, VAR) dump(fp, argv[1], #FILE, #VAR);
 #include "list.h"
@@ -22,6 +22,8 @@
  SOFTWARE.
 **/
 
+#include <algorithm>
+#include <cctype>
 #include <cstdio>
 #include <cstdlib>
 #include <iostream>
@@ -83,6 +85,56 @@ void gendlopen::add_def(const std::string &def)
 }
 
 
+/* add symbol group: <name>:<prefix> */
+void gendlopen::add_group(const std::string &group)
+{
+    size_t pos;
+
+    auto is_ident = [] (const std::string &s) {
+        auto cmp = [] (char c) { return (std::isalnum(static_cast<unsigned char>(c)) || c == '_'); };
+        return (!s.empty() && !std::isdigit(static_cast<unsigned char>(s.front())) &&
+            std::all_of(s.begin(), s.end(), cmp));
+    };
+
+    if (!utils::find(group, ':', pos) || !is_ident(group.substr(0, pos)) ||
+        pos + 1 == group.size())
+    {
+        throw error("symbol group must be `<name>:<prefix>': " + group);
+    }
+
+    m_groups.push_back({ group.substr(0, pos), group.substr(pos + 1) });
+}
+
+
+/* add library map entry: <name>:<prefix>:<library> */
+void gendlopen::add_library_map(const std::string &entry)
+{
+    size_t pos1, pos2;
+
+    auto is_ident = [] (const std::string &s) {
+        auto cmp = [] (char c) { return (std::isalnum(static_cast<unsigned char>(c)) || c == '_'); };
+        return (!s.empty() && !std::isdigit(static_cast<unsigned char>(s.front())) &&
+            std::all_of(s.begin(), s.end(), cmp));
+    };
+
+    if (!utils::find(entry, ':', pos1) || !is_ident(entry.substr(0, pos1)) ||
+        (pos2 = entry.find(':', pos1 + 1)) == std::string::npos ||
+        pos2 == pos1 + 1 || pos2 + 1 == entry.size())
+    {
+        throw error("library map entry must be `<name>:<prefix>:<library>': " + entry);
+    }
+
+    const std::string name = entry.substr(0, pos1);
+
+    /* GDO_LIBRARY_MAIN, GDO_LIBRARY_COUNT and GDO_LIBRARY_FILENAME() */
+    if (name == "MAIN" || name == "COUNT" || name == "FILENAME") {
+        throw error("library name is reserved: " + name);
+    }
+
+    m_library_map.push_back({ name, entry.substr(pos1 + 1, pos2 - pos1 - 1), entry.substr(pos2 + 1) });
+}
+
+
 /* set output format */
 void gendlopen::format(const char *str)
 {
@@ -98,6 +150,8 @@ void gendlopen::format(const char *str)
         format(output::minimal_cxx);
     } else if (s == "plugin" || s == "plugin-c") {
         format(output::plugin);
+    } else if (s == "context" || s == "context-c" || s == "ctx") {
+        format(output::context);
     } else {
         throw error("unknown output format: " + std::string(str));
     }
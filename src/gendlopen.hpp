@@ -27,6 +27,8 @@
 #include <stddef.h>
 #include <stdexcept>
 #include <string>
+#include <tuple>
+#include <utility>
 #include <vector>
 #include "cio_ofstream.hpp"
 #include "types.hpp"
@@ -72,6 +74,8 @@ private:
 
     vstring_t m_includes, m_symbol_list, m_prefix_list, m_typedefs;
     vproto_t m_prototypes, m_objects;
+    std::vector<std::pair<std::string, std::string>> m_groups; /* name, prefix */
+    std::vector<std::tuple<std::string, std::string, std::string>> m_library_map; /* name, prefix, library */
     std::string m_defines, m_templates_path;
 
     std::string m_pfx = "gdo"; /* can be mixed case, used to create header name on STDOUT */
@@ -106,6 +110,11 @@ private:
     void dump_templates(const char *dir);
 
     /* generate.cpp */
+    void apply_profile();
+    void create_symbol_tables();
+    void create_symbol_groups();
+    void create_library_map();
+    void embed_library();
     size_t save_data(templates::name file, const template_t *list);
 
     /* substitute.cpp */
@@ -135,6 +144,8 @@ public:
     OPT( param::names,   parameter_names, param::read )
     OPT( std::string,    custom_template, {}          )
     OPT( std::string,    default_lib,     {}          )
+    OPT( std::string,    profile,         {}          )
+    OPT( std::string,    embed,           {}          )
     OPT( bool,           force,           false       )
     OPT( bool,           separate,        false       )
     OPT( bool,           ast_all_symbols, false       )
@@ -150,6 +161,8 @@ public:
     /* gendlopen.cpp */
     void add_inc(const std::string &s);
     void add_def(const std::string &s);
+    void add_group(const std::string &s);
+    void add_library_map(const std::string &s);
     void prefix(const char *str);
     void format(const char *str);
     void print_symbols_to_stdout();
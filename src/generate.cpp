@@ -26,6 +26,7 @@
  * Generate the output data (STDOUT or save to file).
  */
 
+#include <stdint.h>
 #include <stdio.h>
 #include <time.h>
 #include <algorithm>
@@ -37,6 +38,7 @@
 #include <regex>
 #include <sstream>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "cio_ofstream.hpp"
@@ -59,50 +61,126 @@ namespace templates
 
 namespace /* anonymous */
 {
-    bool compare_chars_at(vproto_t &vec, vproto_t::iterator &it0, size_t pos)
+    /**
+     * FNV-1a hash with a murmur3 finalizer, seeded.
+     * This must return the same values as `_gdo_phash()' from common.c.
+     */
+    uint32_t phash(const std::string &str, uint32_t seed)
     {
-        const char *front = (*it0).symbol.c_str();
-
-        for (auto it = vec.begin(); it != vec.end(); it++) {
-            if (it != it0) {
-                char c = (*it).symbol.c_str()[pos];
+        uint32_t h = 2166136261u ^ seed;
 
-                if (c == 0 || c != front[pos]) {
-                    return true;
-                }
-            }
+        for (const char &c : str) {
+            h ^= static_cast<uint8_t>(c);
+            h *= 16777619u;
         }
 
-        return false;
+        h ^= h >> 16;
+        h *= 0x85ebca6bu;
+        h ^= h >> 13;
+        h *= 0xc2b2ae35u;
+        h ^= h >> 16;
+
+        return h;
     }
 
 
     /**
-     * Look for a common symbol prefix.
-     * Many APIs share a common prefix among their symbols.
-     * If you want to load a specific symbol we can use this
-     * later for a faster lookup.
+     * Create a collision-free ("perfect") hash table over all symbol names
+     * using the "hash and displace" method.
+     *
+     * Each symbol is first put into a bucket using the hash with seed 0.
+     * For every bucket a displacement value is searched which, used as a
+     * seed, will place all symbols of that bucket into unused slots.
+     * Bigger buckets are processed first. Empty buckets get a displacement
+     * of 0 so that lookups of unknown names can return early.
+     *
+     * The runtime lookup only needs to calculate two hashes and compare
+     * a single string.
      */
-    std::string get_common_prefix(vproto_t &v_prot, vproto_t &v_obj)
+    void create_perfect_hash(const vstring_t &symbols, std::vector<uint32_t> &displacements,
+                             std::vector<uint32_t> &slots)
     {
-        /* need at least 2 symbols */
-        if ((v_prot.size() + v_obj.size()) < 2) {
-            return {};
+        const size_t size = symbols.size();
+        const uint32_t max_tries = 1u << 24;
+
+        std::vector<std::vector<uint32_t>> buckets(size);
+        std::vector<uint32_t> order(size);
+        std::vector<bool> used(size, false);
+
+        displacements.assign(size, 0);
+        slots.assign(size, 0);
+
+        for (uint32_t i = 0; i < size; i++) {
+            buckets.at(phash(symbols.at(i), 0) % size).push_back(i);
+            order.at(i) = i;
         }
 
-        size_t i;
-        auto it0 = v_prot.empty() ? v_obj.begin() : v_prot.begin();
+        auto comp = [&buckets] (const uint32_t &a, const uint32_t &b) {
+            return (buckets.at(a).size() > buckets.at(b).size());
+        };
 
-        /* compare each letter of every entry */
-        for (i = 0; i < (*it0).symbol.size(); i++) {
-            if (compare_chars_at(v_prot, it0, i) ||
-                compare_chars_at(v_obj, it0, i))
-            {
+        std::stable_sort(order.begin(), order.end(), comp);
+
+        for (const uint32_t &b : order) {
+            const auto &bucket = buckets.at(b);
+            std::vector<uint32_t> pos;
+            uint32_t d;
+
+            if (bucket.empty()) {
+                /* all remaining buckets are empty too */
                 break;
             }
+
+            for (d = 1; d < max_tries; d++) {
+                pos.clear();
+
+                for (const uint32_t &i : bucket) {
+                    uint32_t slot = phash(symbols.at(i), d) % size;
+
+                    if (used.at(slot) || std::find(pos.begin(), pos.end(), slot) != pos.end()) {
+                        break;
+                    }
+
+                    pos.push_back(slot);
+                }
+
+                if (pos.size() == bucket.size()) {
+                    break;
+                }
+            }
+
+            if (d == max_tries) {
+                throw gendlopen::error("failed to create a perfect hash table of the symbol names");
+            }
+
+            displacements.at(b) = d;
+
+            for (size_t j = 0; j < pos.size(); j++) {
+                used.at(pos.at(j)) = true;
+                slots.at(pos.at(j)) = bucket.at(j);
+            }
         }
+    }
+
+
+    /* print a list of numbers as macro, 8 values per line */
+    std::string number_list_macro(const std::string &name, const std::vector<uint32_t> &list)
+    {
+        std::string str = "#define " + name + " \\\n   ";
+
+        for (size_t i = 0; i < list.size(); i++) {
+            str += ' ' + std::to_string(list.at(i));
+
+            if (i + 1 < list.size()) {
+                str += ',';
 
-        return (*it0).symbol.substr(0, i);
+                if ((i + 1) % 8 == 0) {
+                    str += " \\\n   ";
+                }
+            }
+        }
+
+        return str + '\n';
     }
 
 } /* end anonymous namespace */
@@ -145,9 +223,10 @@ std::string quote_lib(const std::string &lib, bool wide)
  * ext:foo    ==>  "foo" GDO_LIBEXTA
  * api:2:foo  ==>  GDO_LIBNAMEA(foo,2)
  *
- * return macros
+ * return macros GDO_HARDCODED_<name>A and GDO_HARDCODED_<name>W
  */
-std::string format_libname(const std::string &str, const std::string &pfx)
+std::string format_libname(const std::string &str, const std::string &pfx,
+                           const std::string &name = "DEFAULT_LIB")
 {
     std::string lib_a, lib_w, out;
 
@@ -197,8 +276,8 @@ std::string format_libname(const std::string &str, const std::string &pfx)
         break;
     }
 
-    out = "#define " + pfx + "_HARDCODED_DEFAULT_LIBA " + lib_a + '\n' +
-          "#define " + pfx + "_HARDCODED_DEFAULT_LIBW " + lib_w + '\n';
+    out = "#define " + pfx + "_HARDCODED_" + name + "A " + lib_a + '\n' +
+          "#define " + pfx + "_HARDCODED_" + name + "W " + lib_w + '\n';
 
     return out;
 }
@@ -278,9 +357,11 @@ size_t includes(const vstring_t &incs, bool is_cxx)
 
     if (is_cxx) {
         str += "#include <cstddef>\n"  /* size_t, NULL, ... */
-               "#include <cstring>\n"; /* strncmp() */
+               "#include <cstdint>\n"  /* uint32_t */
+               "#include <cstring>\n"; /* strcmp() */
     } else {
         str += "#include <stddef.h>\n"
+               "#include <stdint.h>\n"
                "#include <string.h>\n";
     }
 
@@ -386,6 +467,377 @@ size_t line_directive(const size_t lines, bool line_directive, const std::string
 } /* end namespace save */
 
 
+/* read call counts from the profile file, order the symbols by descending
+ * call count and save hot/cold attribute macros for the wrapper functions */
+void gendlopen::apply_profile()
+{
+    std::unordered_map<std::string, uint64_t> counts;
+    vstring_t order;
+    std::string line, list;
+    uint64_t total = 0, sum = 0;
+    size_t lineno = 0;
+    bool eof = false;
+
+    open_file file(m_profile);
+
+    if (!file.is_open()) {
+        throw error("failed to open file for reading: " + m_profile);
+    }
+
+    FILE *fp = file.file_pointer();
+
+    /* parse lines: <symbol> <count> */
+    while (!eof) {
+        int c = fgetc(fp);
+
+        if (c != '\n' && c != EOF) {
+            line.push_back(static_cast<char>(c));
+            continue;
+        }
+
+        eof = (c == EOF);
+        lineno++;
+
+        std::istringstream iss(line);
+        std::string symbol, extra;
+        uint64_t count = 0;
+
+        line.clear();
+
+        if (!(iss >> symbol) || symbol.front() == '#') {
+            continue;
+        }
+
+        if (!(iss >> count) || (iss >> extra)) {
+            throw error(m_profile + ": line " + std::to_string(lineno) +
+                ": expected a symbol name followed by a call count");
+        }
+
+        /* a recorded profile lists the symbols in first-use order */
+        if (count > 0 && counts[symbol] == 0) {
+            order.push_back(symbol);
+        }
+
+        counts[symbol] += count;
+        total += count;
+    }
+
+    auto get_count = [&counts] (const proto_t &p) -> uint64_t {
+        auto it = counts.find(p.symbol);
+        return (it == counts.end()) ? 0 : it->second;
+    };
+
+    auto cmp = [&get_count] (const proto_t &a, const proto_t &b) {
+        return get_count(a) > get_count(b);
+    };
+
+    /* keep the input order for equal counts */
+    std::stable_sort(m_prototypes.begin(), m_prototypes.end(), cmp);
+    std::stable_sort(m_objects.begin(), m_objects.end(), cmp);
+
+    m_defines += "#define " + m_pfx_upper + "_HAVE_PROFILE 1\n";
+
+    /* the most frequently called functions that make up 90% of all calls
+     * are hot, functions that were never called are cold */
+    for (const auto &e : m_prototypes) {
+        const uint64_t count = get_count(e);
+        std::string attr;
+
+        if (count == 0) {
+            attr = m_pfx_upper + "_WRAP_COLD";
+        } else if (sum < total - total / 10) {
+            attr = m_pfx_upper + "_WRAP_HOT";
+        } else {
+            attr = "/**/";
+        }
+
+        sum += count;
+        m_defines += "#define " + m_pfx_upper + "_WRAP_ATTR_" + e.symbol + ' ' + attr + '\n';
+    }
+
+    auto is_symbol = [this] (const std::string &symbol) {
+        auto cmp = [&symbol] (const proto_t &p) { return p.symbol == symbol; };
+        return std::any_of(m_prototypes.begin(), m_prototypes.end(), cmp) ||
+            std::any_of(m_objects.begin(), m_objects.end(), cmp);
+    };
+
+    /* symbols that were used, loaded eagerly in this order */
+    for (const auto &e : order) {
+        if (is_symbol(e)) {
+            list += " \\\n    " + m_pfx_upper + "_LOAD_" + e + ',';
+        }
+    }
+
+    if (!list.empty()) {
+        list.pop_back();
+        m_defines += "#define " + m_pfx_upper + "_PROFILE_SYMBOLS" + list + '\n';
+    }
+}
+
+
+/* create the symbol name pool offsets and perfect hash tables over
+ * all symbol names, save them as macros */
+void gendlopen::create_symbol_tables()
+{
+    vstring_t symbols;
+    std::vector<uint32_t> offsets, displacements, slots;
+    std::string pool;
+
+    /* same order as the GDO_LOAD_* enumeration values */
+    for (const auto &e : m_prototypes) {
+        symbols.push_back(e.symbol);
+    }
+
+    for (const auto &e : m_objects) {
+        symbols.push_back(e.symbol);
+    }
+
+    /* offsets into a pool of null-terminated strings */
+    for (const auto &e : symbols) {
+        offsets.push_back(static_cast<uint32_t>(pool.size()));
+        pool += e;
+        pool.push_back(0);
+    }
+
+    create_perfect_hash(symbols, displacements, slots);
+
+    m_defines += "#define " + m_pfx_upper + "_SYMBOL_COUNT " + std::to_string(symbols.size()) + '\n';
+    m_defines += "#define " + m_pfx_upper + "_SYMBOL_POOL_SIZE " + std::to_string(pool.size()) + '\n';
+    m_defines += "#define " + m_pfx_upper + "_SYMBOL_POOL_HASH " + utils::hex_literal(phash(pool, 0)) + '\n';
+    m_defines += number_list_macro(m_pfx_upper + "_SYMBOL_POOL_OFFSETS", offsets);
+    m_defines += number_list_macro(m_pfx_upper + "_PHASH_DISPLACEMENTS", displacements);
+    m_defines += number_list_macro(m_pfx_upper + "_PHASH_SLOTS", slots);
+}
+
+
+/* symbol groups: masks over the words of the loaded symbols bitmap,
+ * saved as macros; only words that contain symbols of a group are used */
+void gendlopen::create_symbol_groups()
+{
+    vstring_t names, symbols;
+    std::vector<uint32_t> offsets, words, bits;
+
+    /* same order as the GDO_LOAD_* enumeration values */
+    for (const auto &e : m_prototypes) {
+        symbols.push_back(e.symbol);
+    }
+
+    for (const auto &e : m_objects) {
+        symbols.push_back(e.symbol);
+    }
+
+    /* groups declared more than once get all prefixes */
+    for (const auto &e : m_groups) {
+        if (std::find(names.begin(), names.end(), e.first) == names.end()) {
+            names.push_back(e.first);
+        }
+    }
+
+    for (size_t i = 0; i < names.size(); i++) {
+        std::vector<uint32_t> mask((symbols.size() + 31) / 32, 0);
+        bool empty = true;
+
+        for (const auto &e : m_groups) {
+            if (e.first != names.at(i)) {
+                continue;
+            }
+
+            for (size_t j = 0; j < symbols.size(); j++) {
+                if (symbols.at(j).starts_with(e.second)) {
+                    mask.at(j / 32) |= 1u << (j % 32);
+                    empty = false;
+                }
+            }
+        }
+
+        if (empty) {
+            throw error("symbol group `" + names.at(i) + "' doesn't match any symbols");
+        }
+
+        offsets.push_back(static_cast<uint32_t>(words.size()));
+
+        for (size_t j = 0; j < mask.size(); j++) {
+            if (mask.at(j) != 0) {
+                words.push_back(static_cast<uint32_t>(j));
+                bits.push_back(mask.at(j));
+            }
+        }
+
+        const std::string group = m_pfx_upper + "_GROUP_" + names.at(i);
+        m_defines += "#define " + group + ' ' + std::to_string(i) + '\n';
+
+        /* convenience function macros */
+        if (m_format == output::c) {
+            m_defines += "#define " + m_pfx_lower + "_load_group_" + names.at(i) +
+                "() " + m_pfx_lower + "_load_group(" + group + ")\n";
+            m_defines += "#define " + m_pfx_lower + "_group_loaded_" + names.at(i) +
+                "() " + m_pfx_lower + "_group_loaded(" + group + ")\n";
+        }
+    }
+
+    offsets.push_back(static_cast<uint32_t>(words.size()));
+
+    m_defines += "#define " + m_pfx_upper + "_GROUP_COUNT " + std::to_string(names.size()) + '\n';
+    m_defines += number_list_macro(m_pfx_upper + "_GROUP_MASK_OFFSETS", offsets);
+    m_defines += number_list_macro(m_pfx_upper + "_GROUP_MASK_WORDS", words);
+    m_defines += number_list_macro(m_pfx_upper + "_GROUP_MASK_BITS", bits);
+}
+
+
+/* library map: the library of each symbol, masks of the symbols of each
+ * library (like the symbol groups) and the library filenames, saved as macros;
+ * symbols are looked up in the library with the longest matching prefix,
+ * all others in the main library */
+void gendlopen::create_library_map()
+{
+    vstring_t names, symbols;
+    std::vector<uint32_t> libraries, offsets, words, bits;
+    std::string filenames;
+
+    if (m_format != output::c) {
+        throw error("a library map is only supported by the C output format");
+    }
+
+    /* same order as the GDO_LOAD_* enumeration values */
+    for (const auto &e : m_prototypes) {
+        symbols.push_back(e.symbol);
+    }
+
+    for (const auto &e : m_objects) {
+        symbols.push_back(e.symbol);
+    }
+
+    /* libraries declared more than once get all prefixes;
+     * index 0 is the main library */
+    names.push_back({});
+
+    for (const auto &[name, prefix, lib] : m_library_map) {
+        if (std::find(names.begin(), names.end(), name) != names.end()) {
+            continue;
+        }
+
+        /* all declarations of a library must use the same filename */
+        for (const auto &[name2, prefix2, lib2] : m_library_map) {
+            if (name2 == name && lib2 != lib) {
+                throw error("library `" + name + "' is mapped to different filenames: " +
+                    lib + ", " + lib2);
+            }
+        }
+
+        const std::string macros = save::format_libname(lib, m_pfx_upper, "LIBRARY_" + name);
+
+        if (macros.empty()) {
+            throw error("invalid library filename: " + lib);
+        }
+
+        m_defines += macros;
+        m_defines += "#define " + m_pfx_upper + "_LIBRARY_" + name + ' ' +
+            std::to_string(names.size()) + '\n';
+
+        /* convenience function macros */
+        m_defines += "#define " + m_pfx_lower + "_load_library_symbols_" + name + "() " +
+            m_pfx_lower + "_load_library_symbols(" + m_pfx_upper + "_LIBRARY_" + name + ")\n";
+        m_defines += "#define " + m_pfx_lower + "_library_symbols_loaded_" + name + "() " +
+            m_pfx_lower + "_library_symbols_loaded(" + m_pfx_upper + "_LIBRARY_" + name + ")\n";
+
+        filenames += " \\\n    " + m_pfx_upper + "_LIBRARY_FILENAME(" + name + "),";
+        names.push_back(name);
+    }
+
+    filenames.pop_back();
+
+    /* library of each symbol */
+    for (const auto &sym : symbols) {
+        size_t len = 0;
+        uint32_t idx = 0;
+
+        for (const auto &[name, prefix, lib] : m_library_map) {
+            if (prefix.size() > len && sym.starts_with(prefix)) {
+                len = prefix.size();
+                idx = static_cast<uint32_t>(std::find(names.begin(), names.end(), name) - names.begin());
+            }
+        }
+
+        libraries.push_back(idx);
+    }
+
+    for (size_t i = 0; i < names.size(); i++) {
+        std::vector<uint32_t> mask((symbols.size() + 31) / 32, 0);
+        bool empty = true;
+
+        for (size_t j = 0; j < symbols.size(); j++) {
+            if (libraries.at(j) == i) {
+                mask.at(j / 32) |= 1u << (j % 32);
+                empty = false;
+            }
+        }
+
+        if (empty && i > 0) {
+            throw error("library `" + names.at(i) + "' doesn't match any symbols");
+        }
+
+        offsets.push_back(static_cast<uint32_t>(words.size()));
+
+        for (size_t j = 0; j < mask.size(); j++) {
+            if (mask.at(j) != 0) {
+                words.push_back(static_cast<uint32_t>(j));
+                bits.push_back(mask.at(j));
+            }
+        }
+    }
+
+    offsets.push_back(static_cast<uint32_t>(words.size()));
+
+    m_defines += "#define " + m_pfx_upper + "_LIBRARY_COUNT " + std::to_string(names.size()) + '\n';
+    m_defines += "#define " + m_pfx_upper + "_LIBMAP_FILENAMES" + filenames + '\n';
+    m_defines += number_list_macro(m_pfx_upper + "_LIBMAP_SYMBOLS", libraries);
+    m_defines += number_list_macro(m_pfx_upper + "_LIBMAP_MASK_OFFSETS", offsets);
+    m_defines += number_list_macro(m_pfx_upper + "_LIBMAP_MASK_WORDS", words);
+    m_defines += number_list_macro(m_pfx_upper + "_LIBMAP_MASK_BITS", bits);
+}
+
+
+/* save the content of a file as list of bytes, to be embedded into the program */
+void gendlopen::embed_library()
+{
+    const char *hex = "0123456789abcdef";
+    std::string list;
+    uint8_t buf[4096];
+    size_t size = 0;
+    size_t n;
+
+    open_file file(m_embed);
+
+    if (!file.is_open()) {
+        throw error("failed to open file for reading: " + m_embed);
+    }
+
+    FILE *fp = file.file_pointer();
+
+    /* 16 values per line */
+    while ((n = fread(buf, 1, sizeof(buf), fp)) > 0) {
+        for (size_t i = 0; i < n; i++, size++) {
+            if (size > 0) {
+                list += (size % 16 == 0) ? ", \\\n    " : ", ";
+            }
+
+            list += "0x";
+            list += hex[buf[i] >> 4];
+            list += hex[buf[i] & 0x0f];
+        }
+    }
+
+    if (ferror(fp)) {
+        throw error("failed to read file: " + m_embed);
+    } else if (size == 0) {
+        throw error("file is empty: " + m_embed);
+    }
+
+    m_defines += "#define " + m_pfx_upper + "_EMBEDDED_LIB_SIZE " + std::to_string(size) + '\n';
+    m_defines += "#define " + m_pfx_upper + "_EMBEDDED_LIB_DATA \\\n    " + list + '\n';
+}
+
+
 /* save data, replace prefixes, return line count */
 size_t gendlopen::save_data(templates::name file, const template_t *list)
 {
@@ -485,9 +937,28 @@ void gendlopen::generate()
         m_defines += save::format_libname(m_default_lib, m_pfx_upper);
     }
 
-    /* common symbol prefix (can be empty) */
-    m_defines += "#define " + m_pfx_upper + "_COMMON_PREFIX "
-        "\"" + get_common_prefix(m_prototypes, m_objects) + "\"\n";
+    /* order symbols by call counts */
+    if (!m_profile.empty()) {
+        apply_profile();
+    }
+
+    /* symbol name pool and perfect hash tables */
+    create_symbol_tables();
+
+    /* symbol groups */
+    if (!m_groups.empty()) {
+        create_symbol_groups();
+    }
+
+    /* library map */
+    if (!m_library_map.empty()) {
+        create_library_map();
+    }
+
+    /* library image */
+    if (!m_embed.empty()) {
+        embed_library();
+    }
 
     /* define if a prototype has variable arguments */
     for (const auto &e : m_prototypes) {
@@ -53,10 +53,13 @@ namespace help
             "  -D<string>        define a preprocessor macro *\n"
             "  -dump-templates=<path>\n"
             "                    dump internal template files into directory and exit\n"
+            "  -embed=<file>     embed a library file into the generated code (Linux only)\n"
             "  -force            always overwrite existing output files\n"
-            "  -format=<string>  set output format: c (default), c++, plugin, minimal, minimal-c++\n"
+            "  -format=<string>  set output format: c (default), c++, plugin, context, minimal, minimal-c++\n"
             "  -full-help        show more detailed information\n"
             "  -help             display this information\n"
+            "  -group=<name>:<prefix>\n"
+            "                    add symbols prefixed with <prefix> to the symbol group <name> *\n"
             "  -ignore-options   ignore `%option' lines from input file\n"
             "  -include=[nq:]<file>\n"
             "                    include a header file *;\n"
@@ -65,6 +68,9 @@ namespace help
             "                    set a default library name to load; if <mode> is 'nq' no quotes are\n"
             "                    added, 'ext' will append a file extension to the library name and 'api:#'\n"
             "                    will create a library filename with API number\n"
+            "  -library-map=<name>:<prefix>:[<mode>:]<lib>\n"
+            "                    look up symbols prefixed with <prefix> in the library <name> which is\n"
+            "                    loaded together with the main library (C only) *\n"
             "  -line             add `#line' directives to output\n"
             "  -no-date          don't show current date in output\n"
             "  -no-pragma-once   use `#ifndef' header guard instead of `#pragma once'\n"
@@ -74,6 +80,7 @@ namespace help
             "                    modes are: read (default), skip, create\n"
             "  -prefix=<string>  use <string> to prefix functions, macros and C++ namespaces (default: gdo)\n"
             "  -print-symbols    print list of found symbols and exit\n"
+            "  -profile=<file>   order symbols and mark wrapper functions hot/cold by call counts\n"
             "  -S<string>        look for symbol name <string> *\n"
             "  -separate         save output into separate body and header files\n"
             "  -template=<file>  use a custom template (`-format' and `-templates-path' are ignored)\n"
@@ -102,14 +109,18 @@ namespace help
             "\n"
             "    Some options can be set on a line beginning with `%option':\n"
             "    %option D=<string>\n"
+            "    %option embed=<file>\n"
             "    %option format=<string>\n"
+            "    %option group=<name>:<prefix>\n"
             "    %option include=[nq:]<file>\n"
             "    %option library=[<mode>:]<lib>\n"
+            "    %option library-map=<name>:<prefix>:[<mode>:]<lib>\n"
             "    %option line\n"
             "    %option no-date\n"
             "    %option no-pragma-once\n"
             "    %option param=[skip|create|read]\n"
             "    %option prefix=<string>\n"
+            "    %option profile=<file>\n"
             "\n"
             "    See the corresponding command line options for details.\n"
             "\n"
@@ -164,6 +175,18 @@ namespace help
             "\n"
 
 
+            /* E */
+
+            "  -embed=<file>\n"
+            "    Embed the content of <file> into the generated code as a byte array.\n"
+            "    The library can then be loaded from memory with `gdo_load_lib_embedded()'\n"
+            "    in C or `load_embedded()' in C++ (Linux only). Library images compressed\n"
+            "    with zlib or gzip are supported if GDO_USE_ZLIB is defined. Loading\n"
+            "    other library images from memory is enabled with GDO_ENABLE_LOAD_MEMORY.\n"
+            "\n"
+            "\n"
+
+
             /* F */
 
             "  -force\n"
@@ -177,6 +200,7 @@ namespace help
             "    C            -  many features, this is the default\n"
             "    C++          -  many features but no exception handling (due to the design)\n"
             "    plugin       -  intended to write a plugin loader\n"
+            "    context      -  independent library instances with their own symbol tables\n"
             "    minimal      -  small C header\n"
             "    minimal-C++  -  small C++ header with exception handling\n"
             "\n"
@@ -191,6 +215,20 @@ namespace help
             "\n"
 
 
+            /* G */
+
+            "  -group=<name>:<prefix>\n"
+            "    Add all symbols beginning with <prefix> to the symbol group <name>.\n"
+            "    A group can be declared multiple times to add more prefixes.\n"
+            "    The functions `gdo_load_group()' and `gdo_group_loaded()' take the\n"
+            "    generated value `GDO_GROUP_<name>' to load all symbols of the group or\n"
+            "    to check if they were loaded; in C the macros `gdo_load_group_<name>()'\n"
+            "    and `gdo_group_loaded_<name>()' are created too. Checking a group is a\n"
+            "    mask compare on the bitmap of loaded symbols.\n"
+            "\n"
+            "\n"
+
+
             /* H */
 
             "  -help\n"
@@ -241,6 +279,24 @@ namespace help
             "\n"
 
 
+            "  -library-map=<name>:<prefix>:[<mode>:]<lib>\n"
+            "    For APIs that are split over several libraries: symbols beginning with\n"
+            "    <prefix> are looked up in the library <name> instead of the main library.\n"
+            "    <lib> is formatted like on `-library'. A library can be declared multiple\n"
+            "    times with the same filename to add more prefixes; if several prefixes\n"
+            "    match a symbol the longest one is used. All libraries of the map are loaded\n"
+            "    on threads of their own while the main library is loaded, and either all\n"
+            "    of them or none are loaded. The functions `gdo_load_library_symbols()' and\n"
+            "    `gdo_library_symbols_loaded()' take the generated value `GDO_LIBRARY_<name>'\n"
+            "    (or `GDO_LIBRARY_MAIN') to load or check the symbols of one library.\n"
+            "    This option is only supported by the C output format.\n"
+            "\n"
+            "    -library=api:0:gtk-3 -library-map=gdk:gdk_:api:0:gdk-3 \\\n"
+            "      -library-map=glib:g_:api:0:glib-2.0 -library-map=gobject:g_object_:api:0:gobject-2.0\n"
+            "\n"
+            "\n"
+
+
             "  -line\n"
             "    Add `#line' directives to the output that will refer to the original template\n"
             "    files.\n"
@@ -317,6 +373,23 @@ namespace help
             "\n"
 
 
+            "  -profile=<file>\n"
+            "    Read a call-frequency profile from <file>. Each line contains a\n"
+            "    symbol name followed by the number of times it was called; empty lines\n"
+            "    and lines beginning with `#' are ignored.\n"
+            "    Symbol pointers are ordered by descending call count, so that the most\n"
+            "    frequently used ones share the same cache lines. Wrapper functions\n"
+            "    accounting for 90% of all calls are marked as hot and always inlined,\n"
+            "    wrapper functions that were never called are marked as cold\n"
+            "    (GCC and Clang only).\n"
+            "    Symbols with a call count are loaded eagerly in the order in which they\n"
+            "    are listed as soon as the library was auto-loaded by\n"
+            "    GDO_ENABLE_AUTOLOAD_LAZY. A profile in first-use order is recorded by\n"
+            "    compiling the generated code with GDO_RECORD_PROFILE=\"<file>\".\n"
+            "\n"
+            "\n"
+
+
             /* S */
 
             "  -S<string>\n"
@@ -370,6 +443,8 @@ namespace help
             "\n"
             "    %%sym_type%%: function or object symbol type\n"
             "    %%symbol%%: function or object symbol name\n"
+            "    %%sym_gnu_hash%%: ELF GNU hash value of the symbol name\n"
+            "    %%sym_sysv_hash%%: ELF SysV hash value of the symbol name\n"
             "\n"
             "    If a line ends on `@' it will be processed together with the next line as if\n"
             "    there was no line break, but the line break will still appear in the output.\n"
@@ -11,3 +11,5 @@ TEMPLATE(minimal.h,         min_c_header)
 TEMPLATE(minimal_cxxeh.hpp, min_cxx_header)
 TEMPLATE(plugin.h,          plugin_header)
 TEMPLATE(plugin.c,          plugin_body)
+TEMPLATE(context.h,         ctx_header)
+TEMPLATE(context.c,         ctx_body)
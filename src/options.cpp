@@ -104,16 +104,22 @@ void gendlopen::parse_cmdline(const int &argc, char ** const &argv)
         } else if (o.arg(p, "dump-templates")) {
             dump_templates(p);
             std::exit(0);
+        } else if (o.arg(p, "embed")) {
+            embed(p);
         } else if (o.arg(p, "format")) {
             format(p);
         } else if (o.flag("force")) {
             force(true);
         } else if (o.arg(p, "include")) {
             add_inc(p);
+        } else if (o.arg(p, "group")) {
+            add_group(p);
         } else if (o.flag("ignore-options")) {
             read_options(false);
         } else if (o.arg(p, "library")) {
             default_lib(p);
+        } else if (o.arg(p, "library-map")) {
+            add_library_map(p);
         } else if (o.flag("line")) {
             line_directive(true);
         } else if (o.flag("no-date")) {
@@ -130,6 +136,8 @@ void gendlopen::parse_cmdline(const int &argc, char ** const &argv)
             parameter_names(p);
         } else if (o.flag("print-symbols")) {
             print_symbols(true);
+        } else if (o.arg(p, "profile")) {
+            profile(p);
         } else if (o.arg(p, "S")) {
             add_sym(p);
         } else if (o.flag("separate")) {
@@ -168,16 +176,24 @@ void gendlopen::parse_options(const vstring_t &options)
             pragma_once(false);
         } else if (get_option(token, p, "D=")) {
             add_def(p);
+        } else if (get_option(token, p, "embed=")) {
+            embed(p);
         } else if (get_option(token, p, "format=")) {
             format(p);
+        } else if (get_option(token, p, "group=")) {
+            add_group(p);
         } else if (get_option(token, p, "include=")) {
             add_inc(p);
         } else if (get_option(token, p, "library=")) {
             default_lib(p);
+        } else if (get_option(token, p, "library-map=")) {
+            add_library_map(p);
         } else if (get_option(token, p, "param=")) {
             parameter_names(p);
         } else if (get_option(token, p, "prefix=")) {
             prefix(p);
+        } else if (get_option(token, p, "profile=")) {
+            profile(p);
         } else {
             throw gendlopen::error("unknown %option string: " + token);
         }
@@ -205,6 +205,15 @@ size_t gendlopen::replace_symbol_names(const std::string &entry)
         utils::replace("%%sym_type%%", type, copy);
         utils::replace("%%symbol%%", symbol, copy);
 
+        /* precomputed ELF hash values */
+        if (utils::find(copy, "%%sym_gnu_hash%%")) {
+            utils::replace("%%sym_gnu_hash%%", utils::hex_literal(utils::gnu_hash(symbol)), copy);
+        }
+
+        if (utils::find(copy, "%%sym_sysv_hash%%")) {
+            utils::replace("%%sym_sysv_hash%%", utils::hex_literal(utils::sysv_hash(symbol)), copy);
+        }
+
         if (m_line_directive) {
             save::ofs << "#line " << m_substitute_lineno << '\n';
             line_count++;
@@ -261,7 +270,9 @@ size_t gendlopen::substitute_line(const template_t &line, bool &param_skip_code)
 
     const list_t symbol_keywords = {
         "%%sym_type%%",
-        "%%symbol%%"
+        "%%symbol%%",
+        "%%sym_gnu_hash%%",
+        "%%sym_sysv_hash%%"
     };
 
     std::string buf;
@@ -10,6 +10,26 @@
 #include <stdlib.h>
 #include <string.h>
 
+#if defined(GDO_ENABLE_ASYNC_LOADING) && !defined(_WIN32)
+# include <errno.h>
+# include <pthread.h>
+# include <time.h>
+#endif
+
+#if defined(GDO_ENABLE_AUTOLOAD_BACKGROUND) && !defined(_WIN32)
+# include <pthread.h>
+#endif
+
+#if defined(GDO_HAVE_IDLE_UNLOAD) && !defined(_WIN32)
+# include <errno.h>
+# include <pthread.h>
+# include <time.h>
+#endif
+
+#if defined(GDO_HAVE_PARALLEL_LOADING) && !defined(_WIN32)
+# include <pthread.h>
+#endif
+
 
 #ifdef _GDO_TARGET_WIDECHAR
 # define GDO_XHS  L"%hs"  /* narrow character string */
@@ -38,12 +58,114 @@
 
 
 /* library handle */
-GDO_OBJ_LINKAGE gdo_handle_t gdo_hndl;
+GDO_OBJ_LINKAGE GDO_CACHELINE_ALIGNED gdo_handle_t gdo_hndl;
+
+
+/* data that is rarely used, kept apart from the symbol pointers */
+typedef struct _gdo_cold
+{
+    bool       free_lib_reg;        /* whether registering the function to automatically */
+                                    /* free the library upon exit was successful */
+    gdo_char_t libpath[GDO_BUFLEN]; /* buffer to save path of loaded library */
+} _gdo_cold_t;
+
+static _gdo_cold_t _gdo_cold;
+
+
+/* loaded symbols */
+static _gdo_loaded_t _gdo_loaded;
+
+
+#ifdef GDO_ENABLE_LOAD_STATS
+/* load diagnostics */
+static gdo_load_stats_t _gdo_stats;
+#endif
+
+
+#ifdef GDO_HAVE_PREFETCH
+/* library that was prefetched with gdo_prefetch() */
+static long _gdo_prefetched = 0;
+#endif
+
+
+#ifdef GDO_HAVE_LOAD_MEMORY
+/* memory file of a library loaded from memory */
+static int _gdo_memfd = -1;
+#endif
+
+
+#if defined(GDO_HAVE_LOAD_MEMORY) && defined(GDO_EMBEDDED_LIB_DATA)
+/* library image embedded with `-embed' */
+static const unsigned char _gdo_embedded_lib[GDO_EMBEDDED_LIB_SIZE] = {
+    GDO_EMBEDDED_LIB_DATA
+};
+#endif
+
+
+/* offsets of the symbol pointers in order of the GDO_LOAD_* values;
+ * unlike a table of addresses this doesn't need any relocations */
+static const size_t _gdo_ptr_offsets[GDO_ENUM_LAST] = {
+    offsetof(gdo_handle_t, GDO_PTR_%%symbol%%),
+};
+
+/* address of a symbol pointer */
+GDO_INLINE void *_gdo_ptr_slot(int symbol_num)
+{
+    return (char *)&gdo_hndl + _gdo_ptr_offsets[symbol_num];
+}
+
+#ifdef GDO_LIBRARY_COUNT
+/* library index of each symbol in order of the GDO_LOAD_* values */
+static const uint16_t _gdo_symbol_libraries[GDO_ENUM_LAST] = {
+    GDO_LIBMAP_SYMBOLS
+};
+#endif
+
+/* handle of the library a symbol is looked up in */
+GDO_INLINE gdo_hmod_t _gdo_symbol_handle(int symbol_num)
+{
+#ifdef GDO_LIBRARY_COUNT
+    const int library = _gdo_symbol_libraries[symbol_num];
+
+    if (library != GDO_LIBRARY_MAIN) {
+        return gdo_hndl.libraries[library - 1];
+    }
+#else
+    GDO_UNUSED_REF(symbol_num);
+#endif
+
+    return gdo_hndl.handle;
+}
+
+#ifdef GDO_HAVE_DLADDR
+/* pointer of a symbol that is looked up in the main library, otherwise NULL */
+GDO_INLINE void *_gdo_main_symbol_ptr(int symbol_num, void *ptr)
+{
+# ifdef GDO_LIBRARY_COUNT
+    if (_gdo_symbol_libraries[symbol_num] != GDO_LIBRARY_MAIN) {
+        return NULL;
+    }
+# else
+    GDO_UNUSED_REF(symbol_num);
+# endif
+
+    return ptr;
+}
+#endif
+
+/* set all symbol pointers, which are placed at the beginning
+ * of the handle, back to NULL and clear the loaded symbols */
+GDO_INLINE void _gdo_clear_symbols(void)
+{
+    memset(&gdo_hndl, 0, offsetof(gdo_handle_t, handle));
+    memset(&_gdo_loaded, 0, sizeof(_gdo_loaded));
+}
 
 
 /* forward declarations */
-GDO_INLINE void _gdo_load_library(const gdo_char_t *filename, int flags, bool new_namespace);
-GDO_INLINE void *_gdo_sym(const char *symbol, const gdo_char_t *msg);
+GDO_INLINE gdo_hmod_t _gdo_load_library(const gdo_char_t *filename, int flags, bool new_namespace);
+GDO_INLINE void *_gdo_sym(int symbol_num);
+GDO_INLINE void *_gdo_ptr_slot(int symbol_num);
 #ifdef GDO_WINAPI
 GDO_INLINE HMODULE _gdo_load_library_ex(const gdo_char_t *filename, int flags);
 #endif
@@ -56,6 +178,12 @@ GDO_INLINE bool _gdo_libpath_dlinfo(void);
 #ifdef GDO_HAVE_DLADDR
 GDO_INLINE bool _gdo_libpath_dladdr(void);
 #endif
+#ifdef GDO_HAVE_LAZY_BINDING
+GDO_INLINE void _gdo_lazy_reset(void);
+#endif
+#ifdef GDO_HAVE_IDLE_UNLOAD
+GDO_INLINE void _gdo_idle_stop(void);
+#endif
 
 
 /* strstr() / wcsstr() */
@@ -83,61 +211,80 @@ GDO_INLINE const gdo_char_t *_gdo_tcsstr(const gdo_char_t *haystack, const gdo_c
 /*****************************************************************************/
 /*                                save error                                 */
 /*****************************************************************************/
+
+/**
+ * Error state of the calling thread. API calls only reset the message
+ * pointer; temporary messages (i.e. from dlerror()) are copied into `buf'
+ * if an error occurs and the final message is formatted by gdo_last_error().
+ */
+typedef struct _gdo_error
+{
+#ifdef GDO_WINAPI
+    DWORD last_errno;            /* value returned by GetLastError() */
+    bool formatted;              /* `buf' contains the formatted message */
+#endif
+    const gdo_char_t *msg;       /* static message, `buf' or NULL */
+    gdo_char_t buf[GDO_BUFLEN];  /* message buffer */
+} _gdo_error_t;
+
+static GDO_THREAD_LOCAL _gdo_error_t _gdo_err;
+
 #ifdef GDO_WINAPI
-# define GDO_SET_LAST_ERRNO(x)  do { gdo_hndl.last_errno = x; } while(0)
+# define GDO_SET_LAST_ERRNO(x)  do { _gdo_err.last_errno = x; } while(0)
 #else
 # define GDO_SET_LAST_ERRNO(x)  /**/
 #endif
 
-/* save message to error buffer */
-GDO_INLINE void _gdo_save_to_errbuf(const gdo_char_t *msg)
+/* clear error */
+GDO_INLINE void _gdo_clear_error(void)
 {
-    if (msg) {
-        GDO_SNPRINTF(gdo_hndl.errbuf, _T("%s"), msg);
-    } else {
-        gdo_hndl.errbuf[0] = 0;
-    }
-
+    _gdo_err.msg = NULL;
 #ifdef GDO_WINAPI
-    gdo_hndl.formatted[0] = 0;
+    _gdo_err.last_errno = 0;
+    _gdo_err.formatted = false;
 #endif
 }
 
+/* set a static error message */
+GDO_INLINE void _gdo_set_error(const gdo_char_t *msg)
+{
+    _gdo_err.msg = msg;
 #ifdef GDO_WINAPI
+    _gdo_err.formatted = false;
+#endif
+}
 
-/* clear error buffers */
-GDO_INLINE void _gdo_clear_error(void)
+/* save a copy of a temporary message to the error buffer */
+GDO_INLINE void _gdo_save_to_errbuf(const gdo_char_t *msg)
 {
-    gdo_hndl.errbuf[0] = 0;
-    gdo_hndl.formatted[0] = 0;
-    gdo_hndl.last_errno = 0;
+    if (msg) {
+        GDO_SNPRINTF(_gdo_err.buf, _T("%s"), msg);
+        _gdo_set_error(_gdo_err.buf);
+    } else {
+        _gdo_set_error(NULL);
+    }
 }
 
+#ifdef GDO_WINAPI
+
 /* save the last system error code; a message for additional information
  * can be provided too. */
 GDO_INLINE void _gdo_save_error(const gdo_char_t *msg)
 {
-    gdo_hndl.last_errno = GetLastError();
+    _gdo_err.last_errno = GetLastError();
     _gdo_save_to_errbuf(msg);
 }
 
 /* sets the "no library was loaded" error message */
 GDO_INLINE void _gdo_set_error_no_library_loaded(void)
 {
-    gdo_hndl.last_errno = ERROR_INVALID_HANDLE;
-    _gdo_save_to_errbuf(_T("no library was loaded"));
+    _gdo_err.last_errno = ERROR_INVALID_HANDLE;
+    _gdo_set_error(_T("no library was loaded"));
 }
 
 #else
 /*********************************** dlfcn ***********************************/
 
-/* clear error buffers */
-GDO_INLINE void _gdo_clear_error(void)
-{
-    dlerror();
-    gdo_hndl.errbuf[0] = 0;
-}
-
 /* save the last message provided by dlerror() */
 GDO_INLINE void _gdo_save_error(const gdo_char_t *msg)
 {
@@ -148,7 +295,7 @@ GDO_INLINE void _gdo_save_error(const gdo_char_t *msg)
 /* sets the "no library was loaded" error message */
 GDO_INLINE void _gdo_set_error_no_library_loaded(void)
 {
-    _gdo_save_to_errbuf("no library was loaded");
+    _gdo_set_error("no library was loaded");
 }
 
 #endif //!GDO_WINAPI
@@ -156,6 +303,167 @@ GDO_INLINE void _gdo_set_error_no_library_loaded(void)
 
 
 
+#ifdef GDO_LIBRARY_COUNT
+/*****************************************************************************/
+/*                   load the libraries of a library map                     */
+/*****************************************************************************/
+
+/* load state of a library of the library map */
+typedef struct _gdo_libmap_load
+{
+    const gdo_char_t *filename;
+    int flags;
+    gdo_hmod_t handle;
+#ifdef GDO_WINAPI
+    DWORD last_errno;
+#endif
+    gdo_char_t msg[GDO_BUFLEN];  /* error message of the loading thread */
+#ifdef GDO_HAVE_PARALLEL_LOADING
+    bool started;                /* whether a thread was started */
+# ifdef _WIN32
+    HANDLE thread;
+# else
+    pthread_t thread;
+# endif
+#endif
+} _gdo_libmap_load_t;
+
+/* loading isn't reentrant anyway, so the state is kept in static memory */
+static _gdo_libmap_load_t _gdo_libmap_loads[GDO_LIBRARY_COUNT - 1];
+
+static const gdo_char_t * const _gdo_libmap_filenames[GDO_LIBRARY_COUNT - 1] = {
+    GDO_LIBMAP_FILENAMES
+};
+
+/* load a library and save the error message, which is thread-local */
+GDO_INLINE void _gdo_libmap_load(_gdo_libmap_load_t *load)
+{
+    load->handle = _gdo_load_library(load->filename, load->flags, false);
+
+    if (!load->handle) {
+#ifdef GDO_WINAPI
+        load->last_errno = GetLastError();
+        GDO_SNPRINTF(load->msg, _T("%s"), load->filename);
+#else
+        const char *msg = dlerror();
+        GDO_SNPRINTF(load->msg, "%s", msg ? msg : load->filename);
+#endif
+    }
+}
+
+#ifdef GDO_HAVE_PARALLEL_LOADING
+# ifdef _WIN32
+static DWORD WINAPI _gdo_libmap_thread(LPVOID arg)
+# else
+static void *_gdo_libmap_thread(void *arg)
+# endif
+{
+    _gdo_libmap_load((_gdo_libmap_load_t *)arg);
+
+    return 0;
+}
+#endif
+
+/* Start loading the libraries of the map, each on a thread of its own.
+ * If a thread can't be started the library is loaded right away. */
+GDO_INLINE void _gdo_libmap_start(int flags)
+{
+    for (int i = 0; i < GDO_LIBRARY_COUNT - 1; i++) {
+        _gdo_libmap_load_t *load = &_gdo_libmap_loads[i];
+
+        load->filename = _gdo_libmap_filenames[i];
+        load->flags = flags;
+        load->handle = NULL;
+
+#ifdef GDO_HAVE_PARALLEL_LOADING
+# ifdef _WIN32
+        load->thread = CreateThread(NULL, 0, _gdo_libmap_thread, load, 0, NULL);
+        load->started = (load->thread != NULL);
+# else
+        load->started = (pthread_create(&load->thread, NULL, _gdo_libmap_thread, load) == 0);
+# endif
+
+        if (load->started) {
+            continue;
+        }
+#endif
+
+        _gdo_libmap_load(load);
+    }
+}
+
+/* Wait for the libraries of the map and save their handles if they and the
+ * main library were loaded, in which case the main library handle is returned.
+ * Otherwise all of them are freed and NULL is returned; if the main library
+ * was loaded the error of the first library that failed is saved. */
+GDO_INLINE gdo_hmod_t _gdo_libmap_join(gdo_hmod_t handle)
+{
+    const _gdo_libmap_load_t *failed = NULL;
+
+    for (int i = 0; i < GDO_LIBRARY_COUNT - 1; i++) {
+        _gdo_libmap_load_t *load = &_gdo_libmap_loads[i];
+
+#ifdef GDO_HAVE_PARALLEL_LOADING
+        if (load->started) {
+# ifdef _WIN32
+            WaitForSingleObject(load->thread, INFINITE);
+            CloseHandle(load->thread);
+# else
+            pthread_join(load->thread, NULL);
+# endif
+        }
+#endif
+
+        if (!load->handle && !failed) {
+            failed = load;
+        }
+    }
+
+    if (handle && !failed) {
+        for (int i = 0; i < GDO_LIBRARY_COUNT - 1; i++) {
+            gdo_hndl.libraries[i] = _gdo_libmap_loads[i].handle;
+        }
+        return handle;
+    }
+
+    for (int i = 0; i < GDO_LIBRARY_COUNT - 1; i++) {
+        if (_gdo_libmap_loads[i].handle) {
+            _gdo_call_dlclose(_gdo_libmap_loads[i].handle);
+        }
+    }
+
+    if (handle) {
+        _gdo_call_dlclose(handle);
+#ifdef GDO_WINAPI
+        _gdo_err.last_errno = failed->last_errno;
+#endif
+        _gdo_save_to_errbuf(failed->msg);
+    }
+
+    return NULL;
+}
+
+/* Free the libraries of the map. Handles are only set back to NULL
+ * if the underlying calls were successful. */
+GDO_INLINE bool _gdo_libmap_free(void)
+{
+    bool rv = true;
+
+    for (int i = 0; i < GDO_LIBRARY_COUNT - 1; i++) {
+        if (gdo_hndl.libraries[i] && !_gdo_call_dlclose(gdo_hndl.libraries[i])) {
+            rv = false;
+            continue;
+        }
+        gdo_hndl.libraries[i] = NULL;
+    }
+
+    return rv;
+}
+/*****************************************************************************/
+#endif //GDO_LIBRARY_COUNT
+
+
+
 /*****************************************************************************/
 /*                load default library with default flags                    */
 /*****************************************************************************/
@@ -213,7 +521,7 @@ GDO_LINKAGE bool gdo_load_lib_args(const gdo_char_t *filename, int flags, bool n
 
     /* consider it an error if the library was already loaded */
     if (gdo_lib_is_loaded()) {
-        _gdo_save_to_errbuf(_T("library already loaded"));
+        _gdo_set_error(_T("library already loaded"));
         return false;
     }
 
@@ -221,23 +529,61 @@ GDO_LINKAGE bool gdo_load_lib_args(const gdo_char_t *filename, int flags, bool n
      * the main program, but we don't want that */
     if (!filename || *filename == 0) {
         GDO_SET_LAST_ERRNO(ERROR_INVALID_NAME);
-        _gdo_save_to_errbuf(_T("empty filename"));
+        _gdo_set_error(_T("empty filename"));
         return false;
     }
 
-    _gdo_load_library(filename, flags, new_namespace);
+#if defined(GDO_LIBRARY_COUNT) && defined(GDO_HAVE_DLMOPEN)
+    /* the libraries would end up in different namespaces */
+    if (new_namespace) {
+        _gdo_set_error(_T("a library map can't be loaded into a new namespace"));
+        return false;
+    }
+#endif
 
-    if (!gdo_lib_is_loaded()) {
+#ifdef GDO_ENABLE_LOAD_STATS
+    const long objects = _gdo_object_count();
+    const uint64_t start = _gdo_time_ns();
+#endif
+
+#ifdef GDO_LIBRARY_COUNT
+    _gdo_libmap_start(flags);
+#endif
+
+    gdo_hmod_t handle = _gdo_load_library(filename, flags, new_namespace);
+
+    if (!handle) {
         _gdo_save_error(filename);
-        return false;
     }
 
-    return true;
+#ifdef GDO_LIBRARY_COUNT
+    /* either all libraries stay loaded or none */
+    handle = _gdo_libmap_join(handle);
+#endif
+
+    gdo_hndl.handle = handle;
+
+#ifdef GDO_HAVE_HUGE_TEXT
+    /* nothing is done if the library wasn't loaded */
+    const uint64_t huge_text = _gdo_remap_huge_text(gdo_hndl.handle);
+    GDO_UNUSED_REF(huge_text);
+#endif
+
+#ifdef GDO_ENABLE_LOAD_STATS
+    _gdo_stats_load(&_gdo_stats, start, objects);
+# ifdef GDO_HAVE_HUGE_TEXT
+    _gdo_stats.huge_text = huge_text;
+# endif
+#endif
+
+    return gdo_lib_is_loaded();
 }
 
 /* call LoadLibraryEx/dlopen/dlmopen */
-GDO_INLINE void _gdo_load_library(const gdo_char_t *filename, int flags, bool new_namespace)
+GDO_INLINE gdo_hmod_t _gdo_load_library(const gdo_char_t *filename, int flags, bool new_namespace)
 {
+    gdo_hmod_t handle;
+
 #ifdef GDO_WINAPI
 
     /* documentation says only backward slash path separators shall
@@ -245,8 +591,7 @@ GDO_INLINE void _gdo_load_library(const gdo_char_t *filename, int flags, bool ne
 
     if (!_tcschr(filename, _T('/'))) {
         /* no forward slash found */
-        gdo_hndl.handle = _gdo_load_library_ex(filename, flags);
-        return;
+        return _gdo_load_library_ex(filename, flags);
     }
 
     /* copy filename and replace path separators */
@@ -259,14 +604,26 @@ GDO_INLINE void _gdo_load_library(const gdo_char_t *filename, int flags, bool ne
     }
 
     GDO_UNUSED_REF(new_namespace);
-    gdo_hndl.handle = _gdo_load_library_ex(copy, flags);
+    handle = _gdo_load_library_ex(copy, flags);
     free(copy);
 
 #else
 
-    gdo_hndl.handle = _gdo_call_dlopen(filename, flags, new_namespace);
+# ifdef GDO_HAVE_PREFETCH
+    _gdo_prefetch_once(&_gdo_prefetched, filename);
+# endif
+
+    handle = _gdo_call_dlopen(filename, flags, new_namespace);
+
+# ifdef GDO_HAVE_PREFETCH
+    if (handle) {
+        _gdo_prefetch_text(handle);
+    }
+# endif
 
 #endif //!GDO_WINAPI
+
+    return handle;
 }
 
 #ifdef GDO_WINAPI
@@ -306,7 +663,7 @@ GDO_INLINE HMODULE _gdo_load_library_ex(const gdo_char_t *filename, int flags)
     }
 
     GDO_SET_LAST_ERRNO(ERROR_INVALID_NAME);
-    _gdo_save_to_errbuf("mbstowcs_s: failed to convert filename");
+    _gdo_set_error("mbstowcs_s: failed to convert filename");
     return NULL;
 # else
     return LoadLibraryEx(filename, NULL, flags);
@@ -317,6 +674,426 @@ GDO_INLINE HMODULE _gdo_load_library_ex(const gdo_char_t *filename, int flags)
 
 
 
+#ifdef GDO_HAVE_LOAD_MEMORY
+/*****************************************************************************/
+/*                       load the library from memory                        */
+/*****************************************************************************/
+GDO_LINKAGE bool gdo_load_lib_memory(const void *data, size_t size, int flags, bool new_namespace)
+{
+    const char *errmsg = NULL;
+
+    _gdo_clear_error();
+
+    /* consider it an error if the library was already loaded */
+    if (gdo_lib_is_loaded()) {
+        _gdo_set_error(_T("library already loaded"));
+        return false;
+    }
+
+    if (!data || size == 0) {
+        _gdo_set_error(_T("empty library image"));
+        return false;
+    }
+
+#if defined(GDO_LIBRARY_COUNT) && defined(GDO_HAVE_DLMOPEN)
+    /* the libraries would end up in different namespaces */
+    if (new_namespace) {
+        _gdo_set_error(_T("a library map can't be loaded into a new namespace"));
+        return false;
+    }
+#endif
+
+#ifdef GDO_ENABLE_LOAD_STATS
+    const long objects = _gdo_object_count();
+    const uint64_t start = _gdo_time_ns();
+#endif
+
+#ifdef GDO_LIBRARY_COUNT
+    _gdo_libmap_start(flags);
+#endif
+
+    gdo_hmod_t handle = _gdo_dlopen_memory(data, size, flags, new_namespace, &_gdo_memfd, &errmsg);
+
+    if (!handle) {
+        if (errmsg) {
+            _gdo_set_error(errmsg);
+        } else {
+            _gdo_save_error(NULL);
+        }
+    }
+
+#ifdef GDO_LIBRARY_COUNT
+    /* either all libraries stay loaded or none */
+    handle = _gdo_libmap_join(handle);
+
+    if (!handle) {
+        _gdo_close_memfd(&_gdo_memfd);
+    }
+#endif
+
+    gdo_hndl.handle = handle;
+
+#ifdef GDO_ENABLE_LOAD_STATS
+    _gdo_stats_load(&_gdo_stats, start, objects);
+#endif
+
+    return gdo_lib_is_loaded();
+}
+
+# ifdef GDO_EMBEDDED_LIB_DATA
+GDO_LINKAGE bool gdo_load_lib_embedded(void)
+{
+    return gdo_load_lib_memory(_gdo_embedded_lib, sizeof(_gdo_embedded_lib),
+                               GDO_DEFAULT_FLAGS, false);
+}
+# endif
+/*****************************************************************************/
+#endif //GDO_HAVE_LOAD_MEMORY
+
+
+
+#ifdef GDO_HAVE_PREFETCH
+/*****************************************************************************/
+/*                   read a library into the page cache                      */
+/*****************************************************************************/
+GDO_LINKAGE bool gdo_prefetch(const gdo_char_t *filename)
+{
+    if (!filename || *filename == 0 || !_gdo_prefetch(filename)) {
+        return false;
+    }
+
+    _gdo_prefetch_mark(&_gdo_prefetched, filename);
+
+    return true;
+}
+/*****************************************************************************/
+#endif //GDO_HAVE_PREFETCH
+
+
+
+/*****************************************************************************/
+/*                   load the library on a background thread                 */
+/*****************************************************************************/
+#ifdef GDO_ENABLE_ASYNC_LOADING
+
+enum {
+    _GDO_ASYNC_IDLE,
+    _GDO_ASYNC_PENDING,
+    _GDO_ASYNC_DONE
+};
+
+/* state of the asynchronous load, protected by the lock below */
+typedef struct _gdo_async
+{
+    int state;                   /* _GDO_ASYNC_* */
+    bool result;                 /* return value of the load */
+    gdo_char_t *filename;        /* copy of the filename */
+    int flags;
+    bool new_namespace;
+    bool load_symbols;
+#ifdef GDO_WINAPI
+    DWORD last_errno;
+#endif
+    bool has_msg;                /* whether an error message was saved */
+    gdo_char_t msg[GDO_BUFLEN];  /* error message of the background thread */
+} _gdo_async_t;
+
+static _gdo_async_t _gdo_async;
+
+#ifdef _WIN32
+static SRWLOCK _gdo_async_lock = SRWLOCK_INIT;
+static CONDITION_VARIABLE _gdo_async_cond = CONDITION_VARIABLE_INIT;
+# define _GDO_ASYNC_LOCK()       AcquireSRWLockExclusive(&_gdo_async_lock)
+# define _GDO_ASYNC_UNLOCK()     ReleaseSRWLockExclusive(&_gdo_async_lock)
+# define _GDO_ASYNC_BROADCAST()  WakeAllConditionVariable(&_gdo_async_cond)
+#else
+static pthread_mutex_t _gdo_async_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t _gdo_async_cond = PTHREAD_COND_INITIALIZER;
+# define _GDO_ASYNC_LOCK()       pthread_mutex_lock(&_gdo_async_lock)
+# define _GDO_ASYNC_UNLOCK()     pthread_mutex_unlock(&_gdo_async_lock)
+# define _GDO_ASYNC_BROADCAST()  pthread_cond_broadcast(&_gdo_async_cond)
+#endif
+
+/* Wait until a pending load has finished. Must be called with the lock held.
+ * Returns `false' on a timeout. */
+GDO_INLINE bool _gdo_async_wait(long timeout_ms)
+{
+#ifdef _WIN32
+    const ULONGLONG end = GetTickCount64() + (ULONGLONG)timeout_ms;
+
+    while (_gdo_async.state == _GDO_ASYNC_PENDING) {
+        DWORD ms = INFINITE;
+
+        if (timeout_ms >= 0) {
+            const ULONGLONG now = GetTickCount64();
+
+            if (now >= end) {
+                return false;
+            }
+            ms = (DWORD)(end - now);
+        }
+
+        SleepConditionVariableSRW(&_gdo_async_cond, &_gdo_async_lock, ms, 0);
+    }
+#else
+    struct timespec ts;
+
+    if (timeout_ms >= 0) {
+        clock_gettime(CLOCK_REALTIME, &ts);
+        ts.tv_sec += timeout_ms / 1000;
+        ts.tv_nsec += (timeout_ms % 1000) * 1000000L;
+
+        if (ts.tv_nsec >= 1000000000L) {
+            ts.tv_sec++;
+            ts.tv_nsec -= 1000000000L;
+        }
+    }
+
+    while (_gdo_async.state == _GDO_ASYNC_PENDING) {
+        if (timeout_ms < 0) {
+            pthread_cond_wait(&_gdo_async_cond, &_gdo_async_lock);
+        } else if (pthread_cond_timedwait(&_gdo_async_cond, &_gdo_async_lock, &ts) == ETIMEDOUT) {
+            return (_gdo_async.state != _GDO_ASYNC_PENDING);
+        }
+    }
+#endif
+
+    return true;
+}
+
+/* used by wrapper functions: block on a pending load */
+GDO_INLINE void _gdo_async_join(void)
+{
+    _GDO_ASYNC_LOCK();
+    _gdo_async_wait(-1);
+    _GDO_ASYNC_UNLOCK();
+}
+
+/* background thread */
+#ifdef _WIN32
+static DWORD WINAPI _gdo_async_thread(LPVOID arg)
+#else
+static void *_gdo_async_thread(void *arg)
+#endif
+{
+    GDO_UNUSED_REF(arg);
+
+    bool rv = gdo_load_lib_args(_gdo_async.filename, _gdo_async.flags, _gdo_async.new_namespace);
+
+    if (rv && _gdo_async.load_symbols) {
+        rv = gdo_load_all_symbols();
+    }
+
+    _GDO_ASYNC_LOCK();
+
+    /* the error state is thread-local, save a copy for the waiting threads */
+    _gdo_async.result = rv;
+    _gdo_async.has_msg = (!rv && _gdo_err.msg);
+
+    if (_gdo_async.has_msg) {
+        GDO_SNPRINTF(_gdo_async.msg, _T("%s"), _gdo_err.msg);
+    }
+#ifdef GDO_WINAPI
+    _gdo_async.last_errno = _gdo_err.last_errno;
+#endif
+
+    free(_gdo_async.filename);
+    _gdo_async.filename = NULL;
+    _gdo_async.state = _GDO_ASYNC_DONE;
+
+    _GDO_ASYNC_BROADCAST();
+    _GDO_ASYNC_UNLOCK();
+
+    return 0;
+}
+
+GDO_LINKAGE bool gdo_load_lib_async(const gdo_char_t *filename, int flags, bool new_namespace,
+                                    bool load_symbols)
+{
+    _gdo_clear_error();
+
+    if (!filename || *filename == 0) {
+        GDO_SET_LAST_ERRNO(ERROR_INVALID_NAME);
+        _gdo_set_error(_T("empty filename"));
+        return false;
+    }
+
+    _GDO_ASYNC_LOCK();
+
+    if (_gdo_async.state == _GDO_ASYNC_PENDING) {
+        _gdo_set_error(_T("asynchronous load already pending"));
+        _GDO_ASYNC_UNLOCK();
+        return false;
+    }
+
+    if (gdo_lib_is_loaded()) {
+        _gdo_set_error(_T("library already loaded"));
+        _GDO_ASYNC_UNLOCK();
+        return false;
+    }
+
+#ifdef _WIN32
+    const size_t size = (_tcslen(filename) + 1) * sizeof(gdo_char_t);
+#else
+    const size_t size = strlen(filename) + 1;
+#endif
+
+    _gdo_async.filename = (gdo_char_t *)malloc(size);
+
+    if (!_gdo_async.filename) {
+        GDO_SET_LAST_ERRNO(ERROR_OUTOFMEMORY);
+        _gdo_set_error(_T("failed to allocate memory"));
+        _GDO_ASYNC_UNLOCK();
+        return false;
+    }
+
+    memcpy(_gdo_async.filename, filename, size);
+    _gdo_async.flags = flags;
+    _gdo_async.new_namespace = new_namespace;
+    _gdo_async.load_symbols = load_symbols;
+    _gdo_async.state = _GDO_ASYNC_PENDING;
+
+#ifdef _WIN32
+    HANDLE thread = CreateThread(NULL, 0, _gdo_async_thread, NULL, 0, NULL);
+    const bool started = (thread != NULL);
+
+    if (started) {
+        CloseHandle(thread);
+    } else {
+        _gdo_save_error(_T("CreateThread()"));
+    }
+#else
+    pthread_t thread;
+    const bool started = (pthread_create(&thread, NULL, _gdo_async_thread, NULL) == 0);
+
+    if (started) {
+        pthread_detach(thread);
+    } else {
+        _gdo_set_error(_T("pthread_create(): failed to create thread"));
+    }
+#endif
+
+    if (!started) {
+        free(_gdo_async.filename);
+        _gdo_async.filename = NULL;
+        _gdo_async.state = _GDO_ASYNC_IDLE;
+    }
+
+    _GDO_ASYNC_UNLOCK();
+
+    return started;
+}
+
+GDO_LINKAGE bool gdo_wait_loaded(long timeout_ms)
+{
+    bool rv = false;
+
+    _gdo_clear_error();
+    _GDO_ASYNC_LOCK();
+
+    if (_gdo_async.state == _GDO_ASYNC_IDLE) {
+        _gdo_set_error(_T("no asynchronous load was started"));
+    } else if (!_gdo_async_wait(timeout_ms)) {
+        GDO_SET_LAST_ERRNO(ERROR_TIMEOUT);
+        _gdo_set_error(_T("timed out waiting for the library to load"));
+    } else if ((rv = _gdo_async.result) == false) {
+        _gdo_save_to_errbuf(_gdo_async.has_msg ? _gdo_async.msg : NULL);
+        GDO_SET_LAST_ERRNO(_gdo_async.last_errno);
+    }
+
+    _GDO_ASYNC_UNLOCK();
+
+    return rv;
+}
+
+#endif //GDO_ENABLE_ASYNC_LOADING
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*               load the remaining symbols in the background                */
+/*****************************************************************************/
+#ifdef GDO_ENABLE_AUTOLOAD_BACKGROUND
+
+typedef struct _gdo_background
+{
+    bool running;   /* thread was started and not joined yet */
+    long cancel;    /* stop loading symbols */
+#ifdef _WIN32
+    HANDLE thread;
+#else
+    pthread_t thread;
+#endif
+} _gdo_background_t;
+
+static _gdo_background_t _gdo_bg;
+
+#ifdef _WIN32
+static DWORD WINAPI _gdo_background_thread(LPVOID arg)
+#else
+static void *_gdo_background_thread(void *arg)
+#endif
+{
+    (void)arg;
+
+    /* errors are reported by the wrapper functions */
+    for (int i = 0; i < GDO_ENUM_LAST; i++) {
+        if (GDO_ATOMIC_LOAD_LONG(&_gdo_bg.cancel)) {
+            break;
+        }
+
+        if (!_gdo_get_ptr(_gdo_ptr_slot(i))) {
+            gdo_load_symbol(i);
+        }
+    }
+
+    return 0;
+}
+
+/* start the background thread; called by the auto-loading thread
+ * after the library and the critical symbols were loaded */
+GDO_INLINE void _gdo_background_start(void)
+{
+    if (_gdo_bg.running) {
+        return;
+    }
+
+    _gdo_bg.cancel = 0;
+
+    /* if no thread can be created the wrapper functions still load
+     * their symbols on their own */
+#ifdef _WIN32
+    _gdo_bg.thread = CreateThread(NULL, 0, _gdo_background_thread, NULL, 0, NULL);
+    _gdo_bg.running = (_gdo_bg.thread != NULL);
+#else
+    _gdo_bg.running = (pthread_create(&_gdo_bg.thread, NULL, _gdo_background_thread, NULL) == 0);
+#endif
+}
+
+/* stop the background thread before the library is freed */
+GDO_INLINE void _gdo_background_stop(void)
+{
+    if (!_gdo_bg.running) {
+        return;
+    }
+
+    GDO_ATOMIC_STORE_LONG(&_gdo_bg.cancel, 1);
+
+#ifdef _WIN32
+    WaitForSingleObject(_gdo_bg.thread, INFINITE);
+    CloseHandle(_gdo_bg.thread);
+#else
+    pthread_join(_gdo_bg.thread, NULL);
+#endif
+
+    _gdo_bg.running = false;
+}
+
+#endif //GDO_ENABLE_AUTOLOAD_BACKGROUND
+/*****************************************************************************/
+
+
+
 /*****************************************************************************/
 /*                whether the library is currently loaded                    */
 /*****************************************************************************/
@@ -335,8 +1112,20 @@ GDO_LINKAGE bool gdo_free_lib(void)
 {
     _gdo_clear_error();
 
+#ifdef GDO_HAVE_IDLE_UNLOAD
+    _gdo_idle_stop();
+#endif
+
+#ifdef GDO_ENABLE_AUTOLOAD_BACKGROUND
+    _gdo_background_stop();
+#endif
+
     if (gdo_lib_is_loaded()) {
-        if (!_gdo_call_dlclose(gdo_hndl.handle))
+        if (
+#ifdef GDO_LIBRARY_COUNT
+            !_gdo_libmap_free() ||
+#endif
+            !_gdo_call_dlclose(gdo_hndl.handle))
         {
 #ifdef GDO_WINAPI
             _gdo_save_error(_T("FreeLibrary()"));
@@ -347,11 +1136,19 @@ GDO_LINKAGE bool gdo_free_lib(void)
         }
     }
 
-    gdo_hndl.libpath[0] = 0;
+#ifdef GDO_HAVE_LOAD_MEMORY
+    _gdo_close_memfd(&_gdo_memfd);
+#endif
+
+    _gdo_cold.libpath[0] = 0;
 
     /* set pointers back to NULL */
     gdo_hndl.handle = NULL;
-    GDO_RAWPTR_%%symbol%% = NULL;
+    _gdo_clear_symbols();
+
+#ifdef GDO_HAVE_LAZY_BINDING
+    _gdo_lazy_reset();
+#endif
 
     return true;
 }
@@ -366,15 +1163,35 @@ GDO_LINKAGE void gdo_force_free_lib(void)
 {
     _gdo_clear_error();
 
+#ifdef GDO_HAVE_IDLE_UNLOAD
+    _gdo_idle_stop();
+#endif
+
+#ifdef GDO_ENABLE_AUTOLOAD_BACKGROUND
+    _gdo_background_stop();
+#endif
+
     if (gdo_lib_is_loaded()) {
+#ifdef GDO_LIBRARY_COUNT
+        _gdo_libmap_free();
+        memset(gdo_hndl.libraries, 0, sizeof(gdo_hndl.libraries));
+#endif
         _gdo_call_dlclose(gdo_hndl.handle);
     }
 
-    gdo_hndl.libpath[0] = 0;
+#ifdef GDO_HAVE_LOAD_MEMORY
+    _gdo_close_memfd(&_gdo_memfd);
+#endif
+
+    _gdo_cold.libpath[0] = 0;
 
     /* set pointers back to NULL */
     gdo_hndl.handle = NULL;
-    GDO_RAWPTR_%%symbol%% = NULL;
+    _gdo_clear_symbols();
+
+#ifdef GDO_HAVE_LAZY_BINDING
+    _gdo_lazy_reset();
+#endif
 }
 /*****************************************************************************/
 
@@ -387,15 +1204,15 @@ GDO_LINKAGE bool gdo_enable_autorelease(void)
 {
     _gdo_clear_error();
 
-    if (!gdo_hndl.free_lib_reg) {
+    if (!_gdo_cold.free_lib_reg) {
         if (atexit(gdo_force_free_lib) == 0) {
-            gdo_hndl.free_lib_reg = true;
+            _gdo_cold.free_lib_reg = true;
         } else {
-            _gdo_save_to_errbuf(_T("atexit(): failed to register `gdo_force_free_lib()'"));
+            _gdo_set_error(_T("atexit(): failed to register `gdo_force_free_lib()'"));
         }
     }
 
-    return gdo_hndl.free_lib_reg;
+    return _gdo_cold.free_lib_reg;
 }
 /*****************************************************************************/
 
@@ -406,13 +1223,7 @@ GDO_LINKAGE bool gdo_enable_autorelease(void)
 /*****************************************************************************/
 GDO_LINKAGE bool gdo_all_symbols_loaded(void)
 {
-    if (true
-        && GDO_RAWPTR_%%symbol%% != NULL
-    ) {
-        return true;
-    }
-
-    return false;
+    return (_gdo_loaded_count(&_gdo_loaded) == GDO_ENUM_LAST);
 }
 /*****************************************************************************/
 
@@ -423,12 +1234,127 @@ GDO_LINKAGE bool gdo_all_symbols_loaded(void)
 /*****************************************************************************/
 GDO_LINKAGE bool gdo_no_symbols_loaded(void)
 {
-    if (true
-        && GDO_RAWPTR_%%symbol%% == NULL
-    ) {
+    return (_gdo_loaded_count(&_gdo_loaded) == 0);
+}
+/*****************************************************************************/
+
+
+
+/*****************************************************************************/
+/*                     check if ANY symbol was loaded                        */
+/*****************************************************************************/
+GDO_LINKAGE bool gdo_any_symbol_loaded(void)
+{
+    return (_gdo_loaded_count(&_gdo_loaded) != 0);
+}
+/*****************************************************************************/
+
+
+
+/*****************************************************************************/
+/*                             load all symbols                              */
+/*****************************************************************************/
+GDO_LINKAGE bool gdo_load_all_symbols(void)
+{
+    _gdo_clear_error();
+
+    if (gdo_all_symbols_loaded()) {
         return true;
     }
 
+    if (!gdo_lib_is_loaded()) {
+        _gdo_set_error_no_library_loaded();
+        return false;
+    }
+
+#ifdef GDO_HAVE_SYMBOL_CACHE
+    /* take symbol offsets from the cache file */
+    if (_gdo_symbol_cache_load(gdo_hndl.handle, _gdo_ptr_slot, &_gdo_loaded)) {
+        return true;
+    }
+#endif
+
+#ifdef GDO_HAVE_ELF_RESOLVER
+    /* resolve most symbols at once */
+    _gdo_elf_resolve_all(gdo_hndl.handle, _gdo_ptr_slot, &_gdo_loaded);
+#endif
+
+    /* get symbol addresses */
+    for (int i = 0; i < GDO_ENUM_LAST; i++) {
+        if (_gdo_get_ptr(_gdo_ptr_slot(i)) != NULL) {
+            continue;
+        }
+
+        void *ptr = _gdo_sym(i);
+
+        if (!ptr) {
+            return false;
+        }
+
+        _gdo_store_symbol(&_gdo_loaded, _gdo_ptr_slot(i), i, ptr);
+    }
+
+#ifdef GDO_HAVE_SYMBOL_CACHE
+    _gdo_symbol_cache_save(gdo_hndl.handle, _gdo_ptr_slot);
+#endif
+
+    return true;
+}
+
+GDO_INLINE void *_gdo_sym(int symbol_num)
+{
+    const char *symbol = _gdo_symbol_name(symbol_num);
+
+#ifdef GDO_ENABLE_LOAD_STATS
+    const uint64_t start = _gdo_time_ns();
+    void *ptr = _gdo_call_dlsym(_gdo_symbol_handle(symbol_num), symbol);
+    _gdo_stats_sym(&_gdo_stats, start, (ptr != NULL));
+#else
+    void *ptr = _gdo_call_dlsym(_gdo_symbol_handle(symbol_num), symbol);
+#endif
+
+    if (!ptr) {
+#ifdef GDO_WINAPI
+        _gdo_err.last_errno = GetLastError();
+        GDO_SNPRINTF(_gdo_err.buf, GDO_XHS, symbol);
+        _gdo_set_error(_gdo_err.buf);
+#else
+        _gdo_save_error(NULL);
+#endif
+    }
+
+    return ptr;
+}
+/*****************************************************************************/
+
+
+
+/*****************************************************************************/
+/*                        load a specific symbol                             */
+/*****************************************************************************/
+GDO_LINKAGE bool gdo_load_symbol(int symbol_num)
+{
+    _gdo_clear_error();
+
+    if (!gdo_lib_is_loaded()) {
+        _gdo_set_error_no_library_loaded();
+        return false;
+    }
+
+    if (symbol_num >= 0 && symbol_num < GDO_ENUM_LAST) {
+        void *slot = _gdo_ptr_slot(symbol_num);
+
+        if (!_gdo_get_ptr(slot)) {
+            _gdo_store_symbol(&_gdo_loaded, slot, symbol_num, _gdo_sym(symbol_num));
+        }
+
+        return (_gdo_get_ptr(slot) != NULL);
+    }
+
+    GDO_SET_LAST_ERRNO(ERROR_NOT_FOUND);
+    GDO_SNPRINTF(_gdo_err.buf, _T("unknown symbol number: %d"), symbol_num);
+    _gdo_set_error(_gdo_err.buf);
+
     return false;
 }
 /*****************************************************************************/
@@ -436,145 +1362,168 @@ GDO_LINKAGE bool gdo_no_symbols_loaded(void)
 
 
 /*****************************************************************************/
-/*                     check if ANY symbol was loaded                        */
+/*                    load a specific symbol by name                         */
 /*****************************************************************************/
-GDO_LINKAGE bool gdo_any_symbol_loaded(void)
+GDO_LINKAGE bool gdo_load_symbol_name(const char *symbol)
 {
-    if (false
-        || GDO_RAWPTR_%%symbol%% != NULL
-    ) {
-        return true;
+    _gdo_clear_error();
+
+    if (!gdo_lib_is_loaded()) {
+        _gdo_set_error_no_library_loaded();
+        return false;
+    }
+
+    if (!symbol || *symbol == 0) {
+        GDO_SET_LAST_ERRNO(ERROR_INVALID_PARAMETER);
+        _gdo_set_error(_T("empty symbol name"));
+        return false;
+    }
+
+    /* perfect hash lookup */
+    const int symbol_num = _gdo_symbol_index(symbol);
+
+    if (symbol_num != -1) {
+        return gdo_load_symbol(symbol_num);
     }
 
+    GDO_SET_LAST_ERRNO(ERROR_NOT_FOUND);
+    GDO_SNPRINTF(_gdo_err.buf, _T("unknown symbol: ") GDO_XHS, symbol);
+    _gdo_set_error(_gdo_err.buf);
+
     return false;
 }
 /*****************************************************************************/
 
 
 
-/*****************************************************************************/
-/*                             load all symbols                              */
-/*****************************************************************************/
-GDO_LINKAGE bool gdo_load_all_symbols(void)
+#if defined(GDO_GROUP_COUNT) || defined(GDO_LIBRARY_COUNT)
+/* load the symbols of a list of masks that weren't loaded yet */
+GDO_INLINE bool _gdo_load_masks(const uint32_t *words, const uint32_t *bits, size_t n)
 {
-    _gdo_clear_error();
-
-    if (gdo_all_symbols_loaded()) {
-        return true;
-    }
-
     if (!gdo_lib_is_loaded()) {
         _gdo_set_error_no_library_loaded();
         return false;
     }
 
     /* get symbol addresses */
+    for (size_t i = 0; i < n; i++) {
+        for (int j = 0; j < 32; j++) {
+            const int symbol_num = (int)words[i] * 32 + j;
 
-    /* %%symbol%% */@
-    if ((GDO_RAWPTR_%%symbol%% =@
-            (%%sym_type%%)@
-                _gdo_sym("%%symbol%%", _T("%%symbol%%"))) == NULL) {@
-        return false;@
-    }@
+            if ((bits[i] & ((uint32_t)1 << j)) == 0 ||
+                _gdo_get_ptr(_gdo_ptr_slot(symbol_num)) != NULL)
+            {
+                continue;
+            }
 
-    return true;
-}
+            void *ptr = _gdo_sym(symbol_num);
 
-GDO_INLINE void *_gdo_sym(const char *symbol, const gdo_char_t *msg)
-{
-    void *ptr = _gdo_call_dlsym(gdo_hndl.handle, symbol);
+            if (!ptr) {
+                return false;
+            }
 
-    if (!ptr) {
-        _gdo_save_error(msg);
+            _gdo_store_symbol(&_gdo_loaded, _gdo_ptr_slot(symbol_num), symbol_num, ptr);
+        }
     }
 
-    return ptr;
+    return true;
 }
-/*****************************************************************************/
+#endif
 
 
 
+#ifdef GDO_GROUP_COUNT
 /*****************************************************************************/
-/*                        load a specific symbol                             */
+/*                     load all symbols of a group                           */
 /*****************************************************************************/
-GDO_LINKAGE bool gdo_load_symbol(int symbol_num)
+GDO_LINKAGE bool gdo_load_group(int group)
 {
+    const uint32_t *words, *bits;
+
     _gdo_clear_error();
 
-    if (!gdo_lib_is_loaded()) {
-        _gdo_set_error_no_library_loaded();
+    if (group < 0 || group >= GDO_GROUP_COUNT) {
+        GDO_SET_LAST_ERRNO(ERROR_NOT_FOUND);
+        GDO_SNPRINTF(_gdo_err.buf, _T("unknown symbol group: %d"), group);
+        _gdo_set_error(_gdo_err.buf);
         return false;
     }
 
-    switch (symbol_num)
-    {
-    /* %%symbol%% */@
-    case GDO_LOAD_%%symbol%%:@
-        if (!GDO_RAWPTR_%%symbol%%) {@
-            GDO_RAWPTR_%%symbol%% =@
-                (%%sym_type%%)@
-                    _gdo_sym("%%symbol%%", _T("%%symbol%%"));@
-        }@
-        return (GDO_RAWPTR_%%symbol%% != NULL);@
-
-    default:
-        break;
+    if (_gdo_group_loaded(&_gdo_loaded, group)) {
+        return true;
     }
 
-    GDO_SET_LAST_ERRNO(ERROR_NOT_FOUND);
-    GDO_SNPRINTF(gdo_hndl.errbuf, _T("unknown symbol number: %d"), symbol_num);
+    const size_t n = _gdo_group_masks(group, &words, &bits);
 
-    return false;
+    return _gdo_load_masks(words, bits, n);
 }
 /*****************************************************************************/
 
 
 
 /*****************************************************************************/
-/*                    load a specific symbol by name                         */
+/*               check if all symbols of a group were loaded                 */
 /*****************************************************************************/
-GDO_LINKAGE bool gdo_load_symbol_name(const char *symbol)
+GDO_LINKAGE bool gdo_group_loaded(int group)
+{
+    return (group >= 0 && group < GDO_GROUP_COUNT && _gdo_group_loaded(&_gdo_loaded, group));
+}
+/*****************************************************************************/
+#endif //GDO_GROUP_COUNT
+
+
+
+#ifdef GDO_LIBRARY_COUNT
+/*****************************************************************************/
+/*            load all symbols of a library of the library map               */
+/*****************************************************************************/
+GDO_LINKAGE bool gdo_load_library_symbols(int library)
 {
+    const uint32_t *words, *bits;
+
     _gdo_clear_error();
 
-    if (!gdo_lib_is_loaded()) {
-        _gdo_set_error_no_library_loaded();
+    if (library < 0 || library >= GDO_LIBRARY_COUNT) {
+        GDO_SET_LAST_ERRNO(ERROR_NOT_FOUND);
+        GDO_SNPRINTF(_gdo_err.buf, _T("unknown library: %d"), library);
+        _gdo_set_error(_gdo_err.buf);
         return false;
     }
 
-    if (!symbol || *symbol == 0) {
-        GDO_SET_LAST_ERRNO(ERROR_INVALID_PARAMETER);
-        _gdo_save_to_errbuf(_T("empty symbol name"));
-        return false;
+    if (_gdo_library_loaded(&_gdo_loaded, library)) {
+        return true;
     }
 
-    /* check symbol prefix first */
-    const char pfx[] = GDO_COMMON_PREFIX;
-    const size_t pfxlen = sizeof(pfx) - 1;
+    const size_t n = _gdo_library_masks(library, &words, &bits);
 
-    if (pfxlen == 0 || strncmp(symbol, pfx, pfxlen) == 0) {
-        const size_t len = strlen(symbol);
-        const char *curr;
-        size_t curr_len;
-@
-        curr = "%%symbol%%";@
-        curr_len = sizeof("%%symbol%%") - 1;@
-        if (len == curr_len && strcmp(symbol + pfxlen, curr + pfxlen) == 0) {@
-            if (!GDO_RAWPTR_%%symbol%%) {@
-                GDO_RAWPTR_%%symbol%% =@
-                    (%%sym_type%%)@
-                        _gdo_sym("%%symbol%%", _T("%%symbol%%"));@
-            }@
-            return (GDO_RAWPTR_%%symbol%% != NULL);@
-        }
-    }
+    return _gdo_load_masks(words, bits, n);
+}
+/*****************************************************************************/
 
-    GDO_SET_LAST_ERRNO(ERROR_NOT_FOUND);
-    GDO_SNPRINTF(gdo_hndl.errbuf, _T("unknown symbol: ") GDO_XHS, symbol);
 
-    return false;
+
+/*****************************************************************************/
+/*       check if all symbols of a library of the library map were loaded    */
+/*****************************************************************************/
+GDO_LINKAGE bool gdo_library_symbols_loaded(int library)
+{
+    return (library >= 0 && library < GDO_LIBRARY_COUNT && _gdo_library_loaded(&_gdo_loaded, library));
+}
+/*****************************************************************************/
+#endif //GDO_LIBRARY_COUNT
+
+
+
+#ifdef GDO_ENABLE_LOAD_STATS
+/*****************************************************************************/
+/*                        retrieve load diagnostics                          */
+/*****************************************************************************/
+GDO_LINKAGE void gdo_get_load_stats(gdo_load_stats_t *stats)
+{
+    _gdo_stats_copy(stats, &_gdo_stats);
 }
 /*****************************************************************************/
+#endif //GDO_ENABLE_LOAD_STATS
 
 
 
@@ -585,50 +1534,53 @@ GDO_LINKAGE const gdo_char_t *gdo_last_error(void)
 {
 #ifdef GDO_WINAPI
 
+    gdo_char_t *buf = NULL;
+    size_t len = 0;
+
     /* formatted message was already saved */
-    if (gdo_hndl.formatted[0] != 0) {
-        return gdo_hndl.formatted;
+    if (_gdo_err.formatted) {
+        return _gdo_err.buf;
     }
 
-    gdo_char_t *buf = NULL;
+    /* put custom message in front */
+    if (_gdo_err.msg) {
+        if (_gdo_err.msg != _gdo_err.buf) {
+            GDO_SNPRINTF(_gdo_err.buf, _T("%s"), _gdo_err.msg);
+        }
+
+        len = _tcslen(_gdo_err.buf);
+
+        if (len > 0 && len + 2 < GDO_BUFLEN) {
+            _gdo_err.buf[len++] = _T(':');
+            _gdo_err.buf[len++] = _T(' ');
+        }
+    }
 
     FormatMessage(GDO_FORMAT_MESSAGE_FLAGS,
                   NULL,
-                  gdo_hndl.last_errno,
+                  _gdo_err.last_errno,
                   MAKELANGID(LANG_NEUTRAL, SUBLANG_DEFAULT),
                   (gdo_char_t *)&buf,
                   0,
                   NULL);
 
     if (buf) {
-        if (gdo_hndl.errbuf[0] != 0) {
-            /* put custom message in front */
-            GDO_SNPRINTF(gdo_hndl.formatted, _T("%s: %s"), gdo_hndl.errbuf, buf);
-        } else {
-            GDO_SNPRINTF(gdo_hndl.formatted, _T("%s"), buf);
-        }
-
+        _sntprintf_s(_gdo_err.buf + len, GDO_BUFLEN - len, _TRUNCATE, _T("%s"), buf);
         LocalFree(buf);
     } else {
         /* FormatMessage() failed, save the error code */
-        if (gdo_hndl.errbuf[0] != 0) {
-            /* put custom message in front */
-            GDO_SNPRINTF(gdo_hndl.formatted, _T("%s: error code: %zu"), gdo_hndl.errbuf,
-                (size_t)gdo_hndl.last_errno);
-        } else {
-            GDO_SNPRINTF(gdo_hndl.formatted, _T("error code: %zu"), (size_t)gdo_hndl.last_errno);
-        }
+        _sntprintf_s(_gdo_err.buf + len, GDO_BUFLEN - len, _TRUNCATE, _T("error code: %zu"),
+            (size_t)_gdo_err.last_errno);
     }
 
-    return gdo_hndl.formatted;
+    _gdo_err.msg = _gdo_err.buf;
+    _gdo_err.formatted = true;
 
-#else
+    return _gdo_err.buf;
 
-    if (gdo_hndl.errbuf[0] == 0) {
-        _gdo_save_to_errbuf("no error");
-    }
+#else
 
-    return gdo_hndl.errbuf;
+    return _gdo_err.msg ? _gdo_err.msg : "no error";
 
 #endif //GDO_WINAPI
 }
@@ -644,7 +1596,7 @@ GDO_LINKAGE const gdo_char_t *gdo_library_path(void)
     _gdo_clear_error();
 
 #if !defined(_WIN32) && !defined(_AIX) && !defined(GDO_HAVE_DLINFO) && !defined(GDO_HAVE_DLADDR)
-    _gdo_save_to_errbuf("function not implemented");
+    _gdo_set_error("function not implemented");
     return NULL;
 #endif
 
@@ -654,31 +1606,31 @@ GDO_LINKAGE const gdo_char_t *gdo_library_path(void)
     }
 
     /* was the library path already saved? */
-    if (gdo_hndl.libpath[0] != 0) {
-        return gdo_hndl.libpath;
+    if (_gdo_cold.libpath[0] != 0) {
+        return _gdo_cold.libpath;
     }
 
 #if defined(_WIN32) || defined(_AIX)
     if (_gdo_library_path()) {
-        return gdo_hndl.libpath;
+        return _gdo_cold.libpath;
     }
 #endif
 
 #ifdef GDO_HAVE_DLINFO
     /* prefer dlinfo() over dladdr() */
     if (_gdo_libpath_dlinfo()) {
-        return gdo_hndl.libpath;
+        return _gdo_cold.libpath;
     }
 #endif
 
 #ifdef GDO_HAVE_DLADDR
     if (_gdo_libpath_dladdr()) {
-        return gdo_hndl.libpath;
+        return _gdo_cold.libpath;
     }
 #endif
 
     /* error */
-    gdo_hndl.libpath[0] = 0;
+    _gdo_cold.libpath[0] = 0;
 
     return NULL;
 }
@@ -695,7 +1647,7 @@ GDO_INLINE bool _gdo_library_path(void)
         ? _T("GetModuleFileNameA()")
         : _T("GetModuleFileNameW()");
 
-    DWORD nSize = GetModuleFileName(gdo_hndl.handle, gdo_hndl.libpath, GDO_BUFLEN);
+    DWORD nSize = GetModuleFileName(gdo_hndl.handle, _gdo_cold.libpath, GDO_BUFLEN);
 
     if (nSize == 0 || nSize == GDO_BUFLEN) {
         _gdo_save_error(msg);
@@ -708,13 +1660,13 @@ GDO_INLINE bool _gdo_library_path(void)
      * The handle returned by dlopen() is a `HMODULE' casted to `void *',
      * so we can directly use GetModuleFileNameA() to receive the DLL path. */
 
-    DWORD nSize = GetModuleFileNameA((HMODULE)gdo_hndl.handle, gdo_hndl.libpath, GDO_BUFLEN);
+    DWORD nSize = GetModuleFileNameA((HMODULE)gdo_hndl.handle, _gdo_cold.libpath, GDO_BUFLEN);
 
     if (nSize == 0) {
-        _gdo_save_to_errbuf("failed to get the library path");
+        _gdo_set_error("failed to get the library path");
         return false;
     } else if (nSize == GDO_BUFLEN) {
-        _gdo_save_to_errbuf("buffer is too small to hold the library path");
+        _gdo_set_error("buffer is too small to hold the library path");
         return false;
     }
 
@@ -750,7 +1702,7 @@ GDO_INLINE bool _gdo_libpath_from_symptr(struct ld_info *info, uint8_t *sym)
             return false;
         }
 
-        snprintf(gdo_hndl.libpath, len, "%s(%s)", path, member);
+        snprintf(_gdo_cold.libpath, len, "%s(%s)", path, member);
     } else {
         /* path is not an archive */
         len = strlen(path) + 1; /* + NUL byte */
@@ -759,7 +1711,7 @@ GDO_INLINE bool _gdo_libpath_from_symptr(struct ld_info *info, uint8_t *sym)
             return false;
         }
 
-        memcpy(gdo_hndl.libpath, path, len);
+        memcpy(_gdo_cold.libpath, path, len);
     }
 
     return true;
@@ -770,7 +1722,7 @@ GDO_INLINE bool _gdo_library_path(void)
     uint8_t q[GDO_AIX_LOADQUERY_BUFLEN];
 
     if (gdo_no_symbols_loaded()) {
-        _gdo_save_to_errbuf("no symbols were loaded");
+        _gdo_set_error("no symbols were loaded");
         return false;
     }
 
@@ -784,7 +1736,7 @@ GDO_INLINE bool _gdo_library_path(void)
         }
     }
 
-    _gdo_save_to_errbuf("loadquery() failed to get the library path");
+    _gdo_set_error("loadquery() failed to get the library path");
 
     return false;
 }
@@ -805,13 +1757,13 @@ GDO_INLINE bool _gdo_libpath_dlinfo(void)
     }
 
     if (!lm->l_name || lm->l_name[0] == 0) {
-        _gdo_save_to_errbuf("dlinfo() failed to get library path");
+        _gdo_set_error("dlinfo() failed to get library path");
         return false;
     }
 
 # ifdef __linux__
-    /* if the path is relative try to get the full library path from /proc/self/maps */
-    if (lm->l_name[0] != '/' && _gdo_fullpath_procmap(lm, gdo_hndl.libpath, GDO_BUFLEN)) {
+    /* if the path is relative try to get the full library path */
+    if (lm->l_name[0] != '/' && _gdo_fullpath_linkmap(lm, _gdo_cold.libpath, GDO_BUFLEN)) {
         return true;
     }
 # endif
@@ -822,7 +1774,7 @@ GDO_INLINE bool _gdo_libpath_dlinfo(void)
         return false;
     }
 
-    memcpy(gdo_hndl.libpath, lm->l_name, len);
+    memcpy(_gdo_cold.libpath, lm->l_name, len);
 
     return true;
 }
@@ -840,18 +1792,18 @@ GDO_INLINE bool _gdo_libpath_dladdr(void)
     _gdo_clear_error();
 
     if (gdo_no_symbols_loaded()) {
-        _gdo_save_to_errbuf("no symbols were loaded");
+        _gdo_set_error("no symbols were loaded");
         return false;
     }
 
     if (false
-        || _gdo_call_dladdr((void *)GDO_RAWPTR_%%symbol%%, &info)
+        || _gdo_call_dladdr(_gdo_main_symbol_ptr(GDO_LOAD_%%symbol%%, (void *)GDO_RAWPTR_%%symbol%%), &info)
     ) {
         path = info.dli_fname;
     }
 
     if (!path) {
-        _gdo_save_to_errbuf("dladdr() failed to get library path");
+        _gdo_set_error("dladdr() failed to get library path");
         return false;
     }
 
@@ -861,7 +1813,7 @@ GDO_INLINE bool _gdo_libpath_dladdr(void)
         return false;
     }
 
-    memcpy(gdo_hndl.libpath, path, len);
+    memcpy(_gdo_cold.libpath, path, len);
 
     return true;
 }
@@ -881,15 +1833,16 @@ GDO_INLINE bool _gdo_libpath_dladdr(void)
 void _gdo_noop(void) {}
 #endif
 
-GDO_INLINE void _gdo_print_error(const gdo_char_t *fmt, const gdo_char_t *sym, const gdo_char_t *msg)
+GDO_INLINE void _gdo_print_error(const gdo_char_t *fmt, const char *sym, const gdo_char_t *msg)
 {
 #ifdef _WIN32
 
 # ifdef GDO_USE_MESSAGE_BOX
-    /* we can safely use gdo_hndl.errbuf, the last error message
-     * was saved in gdo_hndl.formatted */
-    _sntprintf_s(gdo_hndl.errbuf, GDO_BUFLEN, _TRUNCATE, fmt, sym, msg);
-    MessageBox(NULL, gdo_hndl.errbuf, _T("Error"), MB_OK | MB_ICONERROR);
+    /* fatal error, we're exiting afterwards */
+    static gdo_char_t buf[GDO_BUFLEN];
+
+    _sntprintf_s(buf, GDO_BUFLEN, _TRUNCATE, fmt, sym, msg);
+    MessageBox(NULL, buf, _T("Error"), MB_OK | MB_ICONERROR);
 # else
     _ftprintf_s(stderr, fmt, sym, msg);
     _fputtc(_T('\n'), stderr);
@@ -903,46 +1856,334 @@ GDO_INLINE void _gdo_print_error(const gdo_char_t *fmt, const gdo_char_t *sym, c
 #endif //!_WIN32
 }
 
-/* used by wrapper functions */
-GDO_LINKAGE void _gdo_wrap_check_loaded(void *symptr, int load, const gdo_char_t *sym)
+#ifdef GDO_ENABLE_AUTOLOAD
+/* only one thread at a time may auto-load the library and symbols */
+static long _gdo_autoload_lock = 0;
+#endif
+
+#ifdef GDO_ENABLE_AUTOLOAD_LAZY
+/* symbols loaded right after the library was auto-loaded */
+static const int _gdo_critical_symbols[] = { GDO_CRITICAL_SYMBOLS };
+#endif
+
+#ifdef GDO_HAVE_IDLE_UNLOAD
+
+/* references held by wrapper function calls */
+GDO_OBJ_LINKAGE GDO_CACHELINE_ALIGNED _gdo_idle_refs_t _gdo_idle_refs;
+
+/* thread that frees the library once it's idle, protected by the lock below */
+typedef struct _gdo_idle
+{
+    bool running;  /* thread was started and not joined yet */
+    bool stop;     /* let the thread exit */
+    bool loaded;   /* library was auto-loaded and not freed yet */
+#ifdef _WIN32
+    HANDLE thread;
+#else
+    pthread_t thread;
+#endif
+} _gdo_idle_t;
+
+static _gdo_idle_t _gdo_idle;
+
+/* set while `gdo_unload_if_idle()' calls `gdo_free_lib()' */
+static GDO_THREAD_LOCAL bool _gdo_idle_unloading = false;
+
+#ifdef _WIN32
+static SRWLOCK _gdo_idle_lock = SRWLOCK_INIT;
+static CONDITION_VARIABLE _gdo_idle_cond = CONDITION_VARIABLE_INIT;
+# define _GDO_IDLE_LOCK()       AcquireSRWLockExclusive(&_gdo_idle_lock)
+# define _GDO_IDLE_UNLOCK()     ReleaseSRWLockExclusive(&_gdo_idle_lock)
+# define _GDO_IDLE_BROADCAST()  WakeAllConditionVariable(&_gdo_idle_cond)
+#else
+static pthread_mutex_t _gdo_idle_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t _gdo_idle_cond = PTHREAD_COND_INITIALIZER;
+# define _GDO_IDLE_LOCK()       pthread_mutex_lock(&_gdo_idle_lock)
+# define _GDO_IDLE_UNLOCK()     pthread_mutex_unlock(&_gdo_idle_lock)
+# define _GDO_IDLE_BROADCAST()  pthread_cond_broadcast(&_gdo_idle_cond)
+#endif
+
+/* Wait for one timeout period. Must be called with the lock held.
+ * Returns `false' if the thread was woken up to exit or because the
+ * library was freed. */
+GDO_INLINE bool _gdo_idle_wait(void)
+{
+#ifdef _WIN32
+    while (!_gdo_idle.stop && _gdo_idle.loaded) {
+        if (!SleepConditionVariableSRW(&_gdo_idle_cond, &_gdo_idle_lock, GDO_IDLE_TIMEOUT, 0)) {
+            return (GetLastError() == ERROR_TIMEOUT);
+        }
+    }
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_REALTIME, &ts);
+    ts.tv_sec += GDO_IDLE_TIMEOUT / 1000;
+    ts.tv_nsec += (GDO_IDLE_TIMEOUT % 1000) * 1000000L;
+
+    if (ts.tv_nsec >= 1000000000L) {
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000L;
+    }
+
+    while (!_gdo_idle.stop && _gdo_idle.loaded) {
+        if (pthread_cond_timedwait(&_gdo_idle_cond, &_gdo_idle_lock, &ts) == ETIMEDOUT) {
+            return true;
+        }
+    }
+#endif
+
+    return false;
+}
+
+#ifdef _WIN32
+static DWORD WINAPI _gdo_idle_thread(LPVOID arg)
+#else
+static void *_gdo_idle_thread(void *arg)
+#endif
+{
+    GDO_UNUSED_REF(arg);
+
+    _GDO_IDLE_LOCK();
+
+    while (!_gdo_idle.stop) {
+        if (!_gdo_idle.loaded) {
+            /* wait until the library is auto-loaded again */
+#ifdef _WIN32
+            SleepConditionVariableSRW(&_gdo_idle_cond, &_gdo_idle_lock, INFINITE, 0);
+#else
+            pthread_cond_wait(&_gdo_idle_cond, &_gdo_idle_lock);
+#endif
+            continue;
+        }
+
+        if (!_gdo_idle_wait()) {
+            continue;
+        }
+
+        /* keep the library if it was used during the last period */
+        if (__atomic_exchange_n(&_gdo_idle_refs.used, 0, __ATOMIC_RELAXED) != 0 ||
+            __atomic_load_n(&_gdo_idle_refs.count, __ATOMIC_RELAXED) != 0)
+        {
+            continue;
+        }
+
+        /* errors are ignored, we try again after the next period */
+        _GDO_IDLE_UNLOCK();
+        gdo_unload_if_idle();
+        _GDO_IDLE_LOCK();
+    }
+
+    _GDO_IDLE_UNLOCK();
+
+    return 0;
+}
+
+/* called with the auto-loading lock held after the library was loaded */
+GDO_INLINE void _gdo_idle_start(void)
+{
+    _GDO_IDLE_LOCK();
+
+    if (!_gdo_idle.loaded) {
+        _gdo_idle.loaded = true;
+
+        if (_gdo_idle.running) {
+            _GDO_IDLE_BROADCAST();
+        } else {
+            /* if no thread can be created the library is never freed */
+            _gdo_idle.stop = false;
+#ifdef _WIN32
+            _gdo_idle.thread = CreateThread(NULL, 0, _gdo_idle_thread, NULL, 0, NULL);
+            _gdo_idle.running = (_gdo_idle.thread != NULL);
+#else
+            _gdo_idle.running = (pthread_create(&_gdo_idle.thread, NULL, _gdo_idle_thread, NULL) == 0);
+#endif
+        }
+    }
+
+    _GDO_IDLE_UNLOCK();
+}
+
+/* stop the thread when the library is freed by other means */
+GDO_INLINE void _gdo_idle_stop(void)
+{
+    if (_gdo_idle_unloading) {
+        return;
+    }
+
+    _GDO_IDLE_LOCK();
+
+    const bool running = _gdo_idle.running;
+    _gdo_idle.stop = true;
+    _gdo_idle.loaded = false;
+    _GDO_IDLE_BROADCAST();
+
+    _GDO_IDLE_UNLOCK();
+
+    if (!running) {
+        return;
+    }
+
+#ifdef _WIN32
+    WaitForSingleObject(_gdo_idle.thread, INFINITE);
+    CloseHandle(_gdo_idle.thread);
+#else
+    pthread_join(_gdo_idle.thread, NULL);
+#endif
+
+    _GDO_IDLE_LOCK();
+    _gdo_idle.running = false;
+    _GDO_IDLE_UNLOCK();
+}
+
+GDO_LINKAGE bool gdo_unload_if_idle(void)
+{
+    bool rv = true;
+
+    _gdo_clear_error();
+
+    /* never wait for the lock, the library may be loaded right now */
+    if (!GDO_ATOMIC_TRYLOCK(&_gdo_autoload_lock)) {
+        _gdo_set_error(_T("library is being loaded"));
+        return false;
+    }
+
+    if (gdo_lib_is_loaded()) {
+        __atomic_store_n(&_gdo_idle_refs.closing, 1, __ATOMIC_SEQ_CST);
+
+        if (__atomic_load_n(&_gdo_idle_refs.count, __ATOMIC_SEQ_CST) == 0) {
+            _gdo_idle_unloading = true;
+            rv = gdo_free_lib();
+            _gdo_idle_unloading = false;
+        } else {
+            _gdo_set_error(_T("library is in use"));
+            rv = false;
+        }
+
+        __atomic_store_n(&_gdo_idle_refs.closing, 0, __ATOMIC_RELEASE);
+    }
+
+    if (rv) {
+        _GDO_IDLE_LOCK();
+        _gdo_idle.loaded = false;
+        _GDO_IDLE_UNLOCK();
+    }
+
+    _gdo_spin_unlock(&_gdo_autoload_lock);
+
+    return rv;
+}
+
+/* used by wrapper functions that are macros: hold a reference forever */
+GDO_LINKAGE void _gdo_idle_pin(void)
 {
+    static long pinned = 0;
+
+    /* racing threads may take more than one reference, which doesn't matter */
+    if (!GDO_ATOMIC_LOAD_LONG(&pinned)) {
+        __atomic_add_fetch(&_gdo_idle_refs.count, 1, __ATOMIC_SEQ_CST);
+        GDO_ATOMIC_STORE_LONG(&pinned, 1);
+    }
+}
+
+#endif //GDO_HAVE_IDLE_UNLOAD
+
+#ifdef GDO_RECORD_PROFILE
+static _gdo_profile_t _gdo_profile;
+
+GDO_INLINE void _gdo_profile_atexit(void)
+{
+    _gdo_profile_save(&_gdo_profile, GDO_RECORD_PROFILE);
+}
+
+/* used by wrapper functions to count their calls */
+GDO_LINKAGE void _gdo_record_call(int load)
+{
+    /* save the profile upon exit, ignore errors */
+    if (_gdo_profile_record(&_gdo_profile, load)) {
+        atexit(_gdo_profile_atexit);
+    }
+}
+#endif
+
+/* used by wrapper functions if the symbol pointer was NULL */
+GDO_LINKAGE void _gdo_wrap_check_loaded(int load)
+{
+    const char *sym = _gdo_symbol_name(load);
     const gdo_char_t *msg;
 
-    /* symbol was already loaded */
-    if (symptr != NULL) {
+#ifdef GDO_ENABLE_ASYNC_LOADING
+    /* block on a pending asynchronous load instead of loading again */
+    _gdo_async_join();
+
+    if (_gdo_get_ptr(_gdo_ptr_slot(load)) != NULL) {
         return;
     }
+#endif
 
 #ifdef GDO_ENABLE_AUTOLOAD
+    _gdo_spin_lock(&_gdo_autoload_lock);
+
+    /* symbol was loaded by another thread in the meantime */
+    if (_gdo_get_ptr(_gdo_ptr_slot(load)) != NULL) {
+        _gdo_spin_unlock(&_gdo_autoload_lock);
+        return;
+    }
+
     /* set auto-release, ignore errors */
     gdo_enable_autorelease();
 
     /* load library */
     if (!gdo_lib_is_loaded()) {
         gdo_load_lib();
+
+# ifdef GDO_ENABLE_AUTOLOAD_LAZY
+        /* load the critical symbols eagerly, errors are reported
+         * once their wrapper functions are called */
+        for (size_t i = 0; i < _countof(_gdo_critical_symbols); i++) {
+            if (_gdo_critical_symbols[i] >= 0 && gdo_lib_is_loaded()) {
+                gdo_load_symbol(_gdo_critical_symbols[i]);
+            }
+        }
+# endif
+    }
+
+# ifdef GDO_ENABLE_AUTOLOAD_BACKGROUND
+    /* load the other symbols without blocking any wrapper function */
+    if (gdo_lib_is_loaded()) {
+        _gdo_background_start();
+    }
+# endif
+
+# ifdef GDO_HAVE_IDLE_UNLOAD
+    /* free the library again once it's idle */
+    if (gdo_lib_is_loaded()) {
+        _gdo_idle_start();
     }
+# endif
 
 # ifdef GDO_ENABLE_AUTOLOAD_LAZY
     /* load a specific symbol */
     if (gdo_load_symbol(load)) {
+        _gdo_spin_unlock(&_gdo_autoload_lock);
         return;
     }
 # else
-    GDO_UNUSED_REF(load);
-
     /* load all symbols */
     if (gdo_load_all_symbols()) {
+        _gdo_spin_unlock(&_gdo_autoload_lock);
         return;
     }
 # endif
 
+    /* keep the lock, we're exiting */
     msg = gdo_last_error();
 
     if (_gdo_tcsstr(msg, GDO_DEFAULT_LIB)) {
         /* library name is already part of error message */
-        _gdo_print_error(_T("error: %s: %s"), sym, msg);
+        _gdo_print_error(_T("error: ") GDO_XHS _T(": %s"), sym, msg);
     } else {
-        _gdo_print_error(_T("error: ") GDO_DEFAULT_LIB _T(": %s: %s"), sym, msg);
+        _gdo_print_error(_T("error: ") GDO_DEFAULT_LIB _T(": ") GDO_XHS _T(": %s"), sym, msg);
     }
 
     gdo_force_free_lib();
@@ -958,14 +2199,49 @@ GDO_LINKAGE void _gdo_wrap_check_loaded(void *symptr, int load, const gdo_char_t
         msg = _T("symbol not loaded");
     }
 
-    GDO_UNUSED_REF(load);
-    _gdo_print_error(_T("fatal error: %s: %s"), sym, msg);
+    _gdo_print_error(_T("fatal error: ") GDO_XHS _T(": %s"), sym, msg);
 
     abort();
 
 #endif //!GDO_ENABLE_AUTOLOAD
 }
 
+
+#ifdef GDO_HAVE_IFUNC
+/* Used by IFUNC resolvers. The dynamic linker may run them while it relocates
+ * an object (i.e. with LD_BIND_NOW or `-z now'), where calling dlopen() or
+ * dlsym() crashes, so nothing is loaded here. */
+GDO_LINKAGE bool _gdo_ifunc_loaded(int load)
+{
+    return (_gdo_get_ptr(_gdo_ptr_slot(load)) != NULL);
+}
+#endif //GDO_HAVE_IFUNC
+
+
+#ifdef GDO_HAVE_LAZY_BINDING
+
+/* resolver stubs: load the symbol, replace the call pointer and call the symbol */
+@
+/* %%func_symbol%%() */@
+#ifndef GDO_HAS_VA_ARGS_%%func_symbol%%@
+static %%type%% _gdo_lazy_stub_%%func_symbol%%(%%args%%) {@
+    _GDO_WRAP_CHECK_LOADED( %%func_symbol%%, GDO_LOAD_%%func_symbol%% );@
+    _GDO_LAZY_SET( %%func_symbol%%, GDO_RAWPTR_%%func_symbol%% );@
+    %%return%% GDO_RAWPTR_%%func_symbol%%( %%param_names%% );@
+}@
+GDO_OBJ_LINKAGE %%type%% (*_gdo_lazy_ptr_%%func_symbol%%)(%%args%%) = _gdo_lazy_stub_%%func_symbol%%;@
+#endif
+
+/* point the call pointers back to the resolver stubs */
+GDO_INLINE void _gdo_lazy_reset(void)
+{
+#ifndef GDO_HAS_VA_ARGS_%%func_symbol%%@
+    _GDO_LAZY_SET( %%func_symbol%%, _gdo_lazy_stub_%%func_symbol%% );@
+#endif
+}
+
+#endif //GDO_HAVE_LAZY_BINDING
+
 #endif // GDO_WRAP_FUNCTIONS || GDO_ENABLE_AUTOLOAD
 /*****************************************************************************/
 %PARAM_SKIP_END%
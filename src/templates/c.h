@@ -35,39 +35,32 @@ enum {
 
 
 /**
- * Library and symbols handle
+ * Library and symbols handle.
+ * The symbol pointers are placed first in a cache-line-aligned block so that
+ * calling different functions touches as few cache lines as possible.
  */
 typedef struct _gdo_handle
 {
-    gdo_hmod_t handle;        /* handle returned by dlopen()/LoadLibraryEx() */
-#ifdef GDO_WINAPI
-    DWORD      last_errno;    /* value returned by GetLastError() */
-#endif
-    bool       free_lib_reg;  /* whether registering the function to automatically */
-                              /* free the library upon exit was successful */
-
     /* symbol pointers; symbol names MUST be prefixed to avoid macro expansion */
     %%type%% (*GDO_PTR_%%func_symbol%%)(%%args%%);
     %%obj_type%% *GDO_PTR_%%obj_symbol%%;
 
-    gdo_char_t libpath[GDO_BUFLEN]; /* buffer to save path of loaded library */
-    gdo_char_t errbuf[GDO_BUFLEN];  /* buffer for error messages */
-
-#ifdef GDO_WINAPI
-    /**
-     * FormatMessage() saves the formatted message string in this buffer;
-     * MSDN says this buffer cannot be larger than 64K bytes (not characters!)
-     */
-    gdo_char_t formatted[(64*1024) / sizeof(gdo_char_t)];
+    gdo_hmod_t handle;  /* handle returned by dlopen()/LoadLibraryEx() */
+#ifdef GDO_LIBRARY_COUNT
+    gdo_hmod_t libraries[GDO_LIBRARY_COUNT - 1];  /* handles of the `-library-map' libraries */
 #endif
 } gdo_handle_t;
 
-GDO_OBJ_DECL gdo_handle_t gdo_hndl;
+GDO_OBJ_DECL GDO_CACHELINE_ALIGNED gdo_handle_t gdo_hndl;
 
 
 /**
  * Load a library.
  *
+ * If the header was created with `-library-map' the libraries of the map are
+ * loaded from their hardcoded filenames on threads of their own while the
+ * main library is loaded. Either all of them or none are loaded.
+ *
  * filename:
  *   Library filename or path to load. Must not be empty or NULL.
  *
@@ -90,8 +83,102 @@ GDO_DECL bool gdo_load_lib_name_and_symbols(const gdo_char_t *filename);
 GDO_DECL bool gdo_load_lib_args(const gdo_char_t *filename, int flags, bool new_namespace);
 
 
+#ifdef GDO_HAVE_LOAD_MEMORY
+/**
+ * Load a library from memory (Linux only, enabled with GDO_ENABLE_LOAD_MEMORY
+ * or `-embed'). The image is copied into an anonymous memory file which is
+ * loaded from its path in `/proc/self/fd', so no library search paths are
+ * looked up.
+ *
+ * data, size:
+ *   Image of a shared library. If GDO_USE_ZLIB is defined the image may also
+ *   be zlib or gzip compressed. It can be freed after the call.
+ *
+ * flags, new_namespace:
+ *   Same as on `gdo_load_lib_args()'.
+ *
+ * gdo_load_lib_embedded() loads the library image that was embedded into the
+ * generated code with the `-embed' option using the default flags.
+ *
+ * On success `true' is returned.
+ * On an error or if the library is already loaded the return value is `false'.
+ */
+GDO_DECL bool gdo_load_lib_memory(const void *data, size_t size, int flags, bool new_namespace);
+# ifdef GDO_EMBEDDED_LIB_DATA
+GDO_DECL bool gdo_load_lib_embedded(void);
+# endif
+#endif
+
+
+#ifdef GDO_HAVE_PREFETCH
+/**
+ * Advise the kernel to read a library and its direct dependencies that aren't
+ * loaded yet into the page cache, so a later load doesn't wait for the disk.
+ * Nothing is loaded. This function can be called from any thread, i.e. from
+ * a helper thread at program start. The next load of the same filename skips
+ * its own prefetch.
+ *
+ * filename:
+ *   Library filename or path, looked up similar to `dlopen()'.
+ *
+ * Returns `false' if the library file wasn't found.
+ */
+GDO_DECL bool gdo_prefetch(const gdo_char_t *filename);
+#endif
+
+
+#ifdef GDO_ENABLE_ASYNC_LOADING
 /**
- * Returns `true' if the library was successfully loaded.
+ * Load a library on a background thread, i.e. to run its constructors and
+ * relocations while the application continues with other initialization.
+ *
+ * filename, flags, new_namespace:
+ *   Same as on `gdo_load_lib_args()'.
+ *
+ * load_symbols:
+ *   If true all symbols are loaded too.
+ *
+ * Returns `false' if the thread couldn't be started, if another load is still
+ * pending or if the library is already loaded.
+ * Don't call any other functions of this API (except wrapper functions, which
+ * wait for the pending load) and don't access any objects until
+ * `gdo_wait_loaded()' returned `true'.
+ */
+GDO_DECL bool gdo_load_lib_async(const gdo_char_t *filename, int flags, bool new_namespace,
+                                 bool load_symbols);
+
+
+/**
+ * Wait for the load started with `gdo_load_lib_async()' to finish.
+ *
+ * timeout_ms:
+ *   Maximum time to wait in milliseconds. Wait without a time limit
+ *   if the value is negative.
+ *
+ * Returns the result of the load. On a timeout `false' is returned
+ * while the load continues in the background.
+ * Errors from the background thread are saved for the calling thread.
+ */
+GDO_DECL bool gdo_wait_loaded(long timeout_ms);
+#endif //GDO_ENABLE_ASYNC_LOADING
+
+
+#ifdef GDO_HAVE_IDLE_UNLOAD
+/**
+ * Free the auto-loaded library right away if no wrapper function call is in
+ * progress, without waiting for the idle timeout of GDO_ENABLE_IDLE_UNLOAD.
+ * The next call of a wrapper function loads it again.
+ *
+ * Returns `true' if the library was freed or wasn't loaded. Returns `false'
+ * if it's in use or if another thread is currently loading it.
+ */
+GDO_DECL bool gdo_unload_if_idle(void);
+#endif
+
+
+/**
+ * Returns `true' if the library (and all libraries of a library map)
+ * was successfully loaded.
  */
 GDO_DECL bool gdo_lib_is_loaded(void);
 
@@ -153,8 +240,58 @@ GDO_DECL bool gdo_no_symbols_loaded(void);
 GDO_DECL bool gdo_any_symbol_loaded(void);
 
 
+#ifdef GDO_GROUP_COUNT
+/**
+ * Load or check a symbol group declared with `%option group=<name>:<prefix>'.
+ *
+ * group:
+ *   Auto-generated value `GDO_GROUP_<name>'.
+ *   The macros `gdo_load_group_<name>()' and `gdo_group_loaded_<name>()'
+ *   can be used instead.
+ *
+ * gdo_load_group() returns `true' on success or if all symbols of the group
+ * were already loaded. Symbols outside of the group are not loaded.
+ */
+GDO_DECL bool gdo_load_group(int group);
+GDO_DECL bool gdo_group_loaded(int group);
+#endif
+
+
+#ifdef GDO_LIBRARY_COUNT
+/* library index of the main library */
+#define GDO_LIBRARY_MAIN 0
+
+/**
+ * Load or check the symbols that are looked up in one library of a
+ * library map declared with `%option library-map=<name>:<prefix>:<lib>'.
+ *
+ * library:
+ *   Auto-generated value `GDO_LIBRARY_<name>' or `GDO_LIBRARY_MAIN' for the
+ *   symbols that don't match any prefix of the map.
+ *   The macros `gdo_load_library_symbols_<name>()' and
+ *   `gdo_library_symbols_loaded_<name>()' can be used instead.
+ *
+ * gdo_load_library_symbols() returns `true' on success or if all symbols of
+ * the library were already loaded. Use `gdo_all_symbols_loaded()' to check
+ * the symbols of all libraries at once.
+ */
+GDO_DECL bool gdo_load_library_symbols(int library);
+GDO_DECL bool gdo_library_symbols_loaded(int library);
+#endif
+
+
+#ifdef GDO_ENABLE_LOAD_STATS
+/**
+ * Copy the load diagnostics into `stats'.
+ * Symbol lookup statistics are summed up over all loads, the load time and
+ * number of new shared objects are taken from the last call to load a library.
+ */
+GDO_DECL void gdo_get_load_stats(gdo_load_stats_t *stats);
+#endif
+
+
 /**
- * Returns a pointer to the last saved error string.
+ * Returns a pointer to the last saved error string of the calling thread.
  * This function doesn't return a null pointer or empty string,
  * the message will indicate if no error had occured.
  * Do not free the returned pointer!
@@ -164,7 +301,8 @@ GDO_DECL const gdo_char_t *gdo_last_error(void)
 
 
 /**
- * Return the library path. On error or if no library was loaded NULL is returned.
+ * Return the library path (of the main library if the header was created with
+ * `-library-map'). On error or if no library was loaded NULL is returned.
  * Do not free the returned pointer!
  *
  * On some systems and configurations the path is taken from the loaded symbols
@@ -197,6 +335,27 @@ extern void _gdo_noop(void);
 #endif
 
 
+/* lazy binding is used on functions without variable arguments or a hook;
+ * not when recording a profile or freeing an idle library, every call must
+ * be counted */
+#if defined(GDO_ENABLE_LAZY_BINDING) && !defined(GDO_RECORD_PROFILE) && \
+    !defined(GDO_HAVE_IDLE_UNLOAD)
+#define GDO_HAVE_LAZY_BINDING
+#if !defined(GDO_HAS_VA_ARGS_%%func_symbol%%) && !defined(GDO_HOOK_%%func_symbol%%)@
+# define _GDO_LAZY_BIND_%%func_symbol%%@
+#endif
+#endif //GDO_ENABLE_LAZY_BINDING && !GDO_RECORD_PROFILE && !GDO_HAVE_IDLE_UNLOAD
+
+
+/* exported wrapper functions without variable arguments or a hook
+ * are indirect functions */
+#ifdef GDO_HAVE_IFUNC
+#if !defined(GDO_HAS_VA_ARGS_%%func_symbol%%) && !defined(GDO_HOOK_%%func_symbol%%)@
+# define _GDO_IFUNC_%%func_symbol%%@
+#endif
+#endif //GDO_HAVE_IFUNC
+
+
 /* by default #define hooks that do nothing */
 #ifndef GDO_HOOK_%%func_symbol%%@
 #define GDO_HOOK_%%func_symbol%%(...)  _gdo_noop()@
@@ -221,15 +380,92 @@ extern void _gdo_noop(void);
 # ifdef GDO_WRAP_VISIBILITY@
 GDO_WARNING("GDO_WRAP_VISIBILITY defined but wrapper function %%func_symbol%%() can only be used inlined; define GDO_DISABLE_WARNINGS to silence this message")@
 # endif@
+# if defined(GDO_HAVE_IDLE_UNLOAD) && !defined(GDO_BUILTIN_VA_ARG_PACK)@
+GDO_WARNING("GDO_ENABLE_IDLE_UNLOAD defined but wrapper function %%func_symbol%%() is a macro and keeps the library loaded once it was called; define GDO_DISABLE_WARNINGS to silence this message")@
+# endif@
 #endif@
 
 #endif //!GDO_DISABLE_WARNINGS
 
 
-GDO_DECL void _gdo_wrap_check_loaded(void *symptr, int load, const gdo_char_t *sym);
+GDO_DECL void _gdo_wrap_check_loaded(int load);
+#ifdef GDO_HAVE_IFUNC
+GDO_DECL bool _gdo_ifunc_loaded(int load);
+#endif
+
+#ifdef GDO_RECORD_PROFILE
+GDO_DECL void _gdo_record_call(int load);
+# define _GDO_RECORD_CALL(LOAD)  _gdo_record_call(LOAD)
+#else
+# define _GDO_RECORD_CALL(LOAD)  (void)0
+#endif
+
+#ifdef GDO_HAVE_IDLE_UNLOAD
+/* kept apart from the symbol pointers, the counter is written on every call */
+typedef struct _gdo_idle_refs
+{
+    long count;    /* wrapper function calls in progress */
+    long used;     /* a wrapper function returned since the last check */
+    long closing;  /* the library is about to be freed */
+} _gdo_idle_refs_t;
+
+GDO_OBJ_DECL GDO_CACHELINE_ALIGNED _gdo_idle_refs_t _gdo_idle_refs;
+GDO_DECL void _gdo_idle_pin(void);
+
+/* called when the reference of a wrapper function goes out of scope */
+static inline void _gdo_idle_release(int *ref)
+{
+    (void)ref;
+    __atomic_store_n(&_gdo_idle_refs.used, 1, __ATOMIC_RELAXED);
+    __atomic_sub_fetch(&_gdo_idle_refs.count, 1, __ATOMIC_RELEASE);
+}
+
+/* The reference is taken before `closing' is checked and the library is
+ * only freed if no references are held after `closing' was set. Both sides
+ * use sequentially consistent operations, so either the wrapper function
+ * sees `closing' and waits on the auto-loading lock, or the library isn't
+ * freed. */
+# define _GDO_IDLE_ACQUIRE \
+    int _gdo_idle_ref __attribute__ ((cleanup (_gdo_idle_release))) = \
+        (__atomic_add_fetch(&_gdo_idle_refs.count, 1, __ATOMIC_SEQ_CST), 0)
+# define _GDO_IDLE_CLOSING  __atomic_load_n(&_gdo_idle_refs.closing, __ATOMIC_SEQ_CST)
+# define _GDO_IDLE_PIN()    _gdo_idle_pin()
+#else
+# define _GDO_IDLE_ACQUIRE  (void)0
+# define _GDO_IDLE_CLOSING  0
+# define _GDO_IDLE_PIN()    (void)0
+#endif
+
+/* Fast path: a single atomic load and a branch.
+ * The GDO_LOAD_* value is passed by the caller: in the variadic macro
+ * fallback SYMBOL is expanded to its alias when used without `##'. */
+#define _GDO_WRAP_CHECK_LOADED(SYMBOL, LOAD) \
+    (_GDO_RECORD_CALL(LOAD), \
+     GDO_UNLIKELY(_GDO_IDLE_CLOSING || !GDO_ATOMIC_LOAD_PTR(&GDO_RAWPTR_##SYMBOL)) ? \
+        _gdo_wrap_check_loaded(LOAD) : (void)0)
+
+
+/**
+ * Lazy binding: wrapper functions call the symbol through a pointer that
+ * initially points to a resolver stub with the same signature. The stub
+ * loads the symbol, replaces the pointer with the symbol address and calls it.
+ * Every later call is a plain indirect call without any checks.
+ */
+#ifdef GDO_HAVE_LAZY_BINDING
+
+#ifndef GDO_HAS_VA_ARGS_%%func_symbol%%@
+GDO_OBJ_DECL %%type%% (*_gdo_lazy_ptr_%%func_symbol%%)(%%args%%);@
+#endif
+
+#ifdef __GNUC__
+# define _GDO_LAZY_PTR(SYMBOL)       __atomic_load_n(&_gdo_lazy_ptr_##SYMBOL, __ATOMIC_ACQUIRE)
+# define _GDO_LAZY_SET(SYMBOL, PTR)  __atomic_store_n(&_gdo_lazy_ptr_##SYMBOL, (PTR), __ATOMIC_RELEASE)
+#else
+# define _GDO_LAZY_PTR(SYMBOL)       _gdo_lazy_ptr_##SYMBOL
+# define _GDO_LAZY_SET(SYMBOL, PTR)  (_gdo_lazy_ptr_##SYMBOL = (PTR))
+#endif
 
-#define _GDO_WRAP_CHECK_LOADED(SYMBOL) \
-    _gdo_wrap_check_loaded( (void *)GDO_RAWPTR_##SYMBOL, GDO_LOAD_##SYMBOL, _T( #SYMBOL ) )
+#endif //GDO_HAVE_LAZY_BINDING
 
 
 /**
@@ -249,22 +485,43 @@ GDO_DECL void _gdo_wrap_check_loaded(void *symptr, int load, const gdo_char_t *s
     /* inline function (always inlined) */@
     extern inline __attribute__ ((__gnu_inline__))@
     %%type%% GDO_WRAP(%%func_symbol%%) (%%args%%) {@
-        _GDO_WRAP_CHECK_LOADED( %%func_symbol%% );@
+        _GDO_IDLE_ACQUIRE;@
+        _GDO_WRAP_CHECK_LOADED( %%func_symbol%%, GDO_LOAD_%%func_symbol%% );@
         GDO_HOOK_%%func_symbol%%( %%param_names%%, __builtin_va_arg_pack() );@
         %%return%% GDO_RAWPTR_%%func_symbol%%( %%param_names%%, __builtin_va_arg_pack() );@
     }@
 # else /* fall back to using a macro */@
 #  define GDO_WRAP_%%func_symbol%%(...) \@
-    (_GDO_WRAP_CHECK_LOADED( %%func_symbol%% ),\@
+    (_GDO_IDLE_PIN(),\@
+     _GDO_WRAP_CHECK_LOADED( %%func_symbol%%, GDO_LOAD_%%func_symbol%% ),\@
      (GDO_HOOK_%%func_symbol%%( __VA_ARGS__ )),\@
       GDO_RAWPTR_%%func_symbol%%( __VA_ARGS__ ))@
 # endif@
+#elif defined(_GDO_IFUNC_%%func_symbol%%)@
+    /* used if the symbol wasn't loaded yet when the IFUNC resolver was run */@
+    static %%type%% _gdo_ifunc_wrap_%%func_symbol%% (%%args%%) {@
+        _GDO_WRAP_CHECK_LOADED( %%func_symbol%%, GDO_LOAD_%%func_symbol%% );@
+        %%return%% GDO_RAWPTR_%%func_symbol%%( %%param_names%% );@
+    }@
+    /* IFUNC resolver */@
+    static %%type%% (*_gdo_ifunc_resolve_%%func_symbol%% (void))(%%args%%) {@
+        return _gdo_ifunc_loaded( GDO_LOAD_%%func_symbol%% ) ?@
+            GDO_RAWPTR_%%func_symbol%% : _gdo_ifunc_wrap_%%func_symbol%%;@
+    }@
+    GDO_WRAP_DECL /* indirect function */@
+    %%type%% GDO_WRAP(%%func_symbol%%) (%%args%%)@
+        __attribute__ ((ifunc ("_gdo_ifunc_resolve_%%func_symbol%%")));@
 #else //!GDO_HAS_VA_ARGS_%%func_symbol%%@
-    GDO_WRAP_DECL /* wrapper function */@
+    GDO_WRAP_DECL GDO_WRAP_ATTR(%%func_symbol%%) /* wrapper function */@
     %%type%% GDO_WRAP(%%func_symbol%%) (%%args%%) {@
-        _GDO_WRAP_CHECK_LOADED( %%func_symbol%% );@
+# ifdef _GDO_LAZY_BIND_%%func_symbol%%@
+        %%return%% _GDO_LAZY_PTR(%%func_symbol%%)( %%param_names%% );@
+# else@
+        _GDO_IDLE_ACQUIRE;@
+        _GDO_WRAP_CHECK_LOADED( %%func_symbol%%, GDO_LOAD_%%func_symbol%% );@
         GDO_HOOK_%%func_symbol%%( %%param_names%% );@
         %%return%% GDO_RAWPTR_%%func_symbol%%( %%param_names%% );@
+# endif@
     }@
 #endif //!GDO_HAS_VA_ARGS_%%func_symbol%%
 
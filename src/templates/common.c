@@ -20,6 +20,279 @@ GDO_INLINE bool _gdo_call_dlclose(gdo_hmod_t handle)
 }
 
 
+/* FNV-1a hash with a murmur3 finalizer, used for symbol name lookups
+ * (must return the same values as the hash function of gendlopen) */
+GDO_INLINE uint32_t _gdo_phash(const char *str, uint32_t seed)
+{
+    const unsigned char *p = (const unsigned char *)str;
+    uint32_t h = 2166136261u ^ seed;
+
+    for ( ; *p != 0; p++) {
+        h ^= *p;
+        h *= 16777619u;
+    }
+
+    h ^= h >> 16;
+    h *= 0x85ebca6bu;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35u;
+    h ^= h >> 16;
+
+    return h;
+}
+
+
+/* type of the offsets into the symbol name pool */
+#if GDO_SYMBOL_POOL_SIZE > 0xffff
+typedef uint32_t _gdo_pool_offset_t;
+#else
+typedef uint16_t _gdo_pool_offset_t;
+#endif
+
+/* Symbol name by GDO_LOAD_* index.
+ * All names are saved into a single string pool. Using offsets instead of
+ * an array of pointers avoids one relocation per symbol name. */
+GDO_INLINE const char *_gdo_symbol_name(int symbol_num)
+{
+    static const char pool[] =
+        "%%symbol%%\0"
+    ;
+    static const _gdo_pool_offset_t offsets[GDO_SYMBOL_COUNT] = { GDO_SYMBOL_POOL_OFFSETS };
+
+    return pool + offsets[symbol_num];
+}
+
+
+/* look up the GDO_LOAD_* index of a symbol name; returns -1 if not found */
+GDO_INLINE int _gdo_symbol_index(const char *symbol)
+{
+    static const uint32_t displacements[GDO_SYMBOL_COUNT] = { GDO_PHASH_DISPLACEMENTS };
+    static const uint32_t slots[GDO_SYMBOL_COUNT] = { GDO_PHASH_SLOTS };
+
+    const uint32_t d = displacements[_gdo_phash(symbol, 0) % GDO_SYMBOL_COUNT];
+
+    if (d == 0) {
+        /* empty bucket */
+        return -1;
+    }
+
+    const int i = (int)slots[_gdo_phash(symbol, d) % GDO_SYMBOL_COUNT];
+
+    return (strcmp(symbol, _gdo_symbol_name(i)) == 0) ? i : -1;
+}
+
+
+/* Read and write symbol pointers through their address, so that all
+ * function and object pointers can be accessed from a single table.
+ * This requires function pointers to have the same size and representation
+ * as data pointers, which is guaranteed by POSIX and the Windows API.
+ * Atomic operations are used so that wrapper functions can safely check
+ * the pointers while another thread is loading symbols. */
+GDO_INLINE void *_gdo_get_ptr(void *slot)
+{
+    return GDO_ATOMIC_LOAD_PTR(slot);
+}
+
+GDO_INLINE void _gdo_set_ptr(void *slot, void *ptr)
+{
+    GDO_ATOMIC_STORE_PTR(slot, ptr);
+}
+
+
+/* Bitmap and number of loaded symbols, updated whenever a symbol pointer
+ * is set. Checking if all, any or no symbols were loaded is then a single
+ * test of the counter instead of a test of every pointer. */
+typedef struct _gdo_loaded
+{
+    uint32_t bits[(GDO_SYMBOL_COUNT + 31) / 32];
+    long count;
+} _gdo_loaded_t;
+
+/* set a symbol pointer and mark the symbol as loaded;
+ * the counter is incremented only once per symbol */
+GDO_INLINE void _gdo_store_symbol(_gdo_loaded_t *loaded, void *slot, int symbol_num, void *ptr)
+{
+    const uint32_t bit = (uint32_t)1 << (symbol_num % 32);
+
+    if (!ptr) {
+        return;
+    }
+
+    _gdo_set_ptr(slot, ptr);
+
+    if ((GDO_ATOMIC_FETCH_OR(&loaded->bits[symbol_num / 32], bit) & bit) == 0) {
+        GDO_ATOMIC_INCREMENT(&loaded->count);
+    }
+}
+
+/* number of loaded symbols */
+GDO_INLINE long _gdo_loaded_count(_gdo_loaded_t *loaded)
+{
+    return GDO_ATOMIC_LOAD_LONG(&loaded->count);
+}
+
+
+#if defined(GDO_GROUP_COUNT) || defined(GDO_LIBRARY_COUNT)
+
+/* whether all symbols of a list of masks were loaded; one mask compare per word */
+GDO_INLINE bool _gdo_masks_loaded(_gdo_loaded_t *loaded, const uint32_t *words, const uint32_t *bits, size_t n)
+{
+    for (size_t i = 0; i < n; i++) {
+        if ((GDO_ATOMIC_LOAD_U32(&loaded->bits[words[i]]) & bits[i]) != bits[i]) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+#endif
+
+
+#ifdef GDO_GROUP_COUNT
+
+/* Masks of a symbol group over the words of the loaded symbols bitmap;
+ * returns the number of masks. Only words that contain symbols of the
+ * group have a mask. */
+GDO_INLINE size_t _gdo_group_masks(int group, const uint32_t **words, const uint32_t **bits)
+{
+    static const uint32_t offsets[GDO_GROUP_COUNT + 1] = { GDO_GROUP_MASK_OFFSETS };
+    static const uint32_t mask_words[] = { GDO_GROUP_MASK_WORDS };
+    static const uint32_t mask_bits[] = { GDO_GROUP_MASK_BITS };
+
+    *words = mask_words + offsets[group];
+    *bits = mask_bits + offsets[group];
+
+    return offsets[group + 1] - offsets[group];
+}
+
+/* whether all symbols of a group were loaded */
+GDO_INLINE bool _gdo_group_loaded(_gdo_loaded_t *loaded, int group)
+{
+    const uint32_t *words, *bits;
+    const size_t n = _gdo_group_masks(group, &words, &bits);
+
+    return _gdo_masks_loaded(loaded, words, bits, n);
+}
+
+#endif //GDO_GROUP_COUNT
+
+
+#ifdef GDO_LIBRARY_COUNT
+
+/* masks of the symbols of a library of the library map, same as above */
+GDO_INLINE size_t _gdo_library_masks(int library, const uint32_t **words, const uint32_t **bits)
+{
+    static const uint32_t offsets[GDO_LIBRARY_COUNT + 1] = { GDO_LIBMAP_MASK_OFFSETS };
+    static const uint32_t mask_words[] = { GDO_LIBMAP_MASK_WORDS };
+    static const uint32_t mask_bits[] = { GDO_LIBMAP_MASK_BITS };
+
+    *words = mask_words + offsets[library];
+    *bits = mask_bits + offsets[library];
+
+    return offsets[library + 1] - offsets[library];
+}
+
+/* whether all symbols of a library were loaded */
+GDO_INLINE bool _gdo_library_loaded(_gdo_loaded_t *loaded, int library)
+{
+    const uint32_t *words, *bits;
+    const size_t n = _gdo_library_masks(library, &words, &bits);
+
+    return _gdo_masks_loaded(loaded, words, bits, n);
+}
+
+#endif //GDO_LIBRARY_COUNT
+
+
+/* spin lock used to serialize auto-loading */
+GDO_INLINE void _gdo_spin_lock(long *lock)
+{
+    while (!GDO_ATOMIC_TRYLOCK(lock)) {
+#ifdef _WIN32
+        SwitchToThread();
+#else
+        sched_yield();
+#endif
+    }
+}
+
+GDO_INLINE void _gdo_spin_unlock(long *lock)
+{
+    GDO_ATOMIC_UNLOCK(lock);
+}
+
+
+#ifdef GDO_RECORD_PROFILE
+
+#include <stdio.h>
+
+/* number of calls and first-use order of each symbol */
+typedef struct _gdo_profile
+{
+    long calls[GDO_SYMBOL_COUNT];
+    long order[GDO_SYMBOL_COUNT];  /* starts at 1; 0 if never called */
+    long next;                     /* last assigned order */
+} _gdo_profile_t;
+
+/* count a call of a wrapper function; returns true on the first call
+ * of any symbol */
+GDO_INLINE bool _gdo_profile_record(_gdo_profile_t *prof, int symbol_num)
+{
+    if (GDO_ATOMIC_INCREMENT(&prof->calls[symbol_num]) != 1) {
+        return false;
+    }
+
+    const long order = GDO_ATOMIC_INCREMENT(&prof->next);
+    GDO_ATOMIC_STORE_LONG(&prof->order[symbol_num], order);
+
+    return (order == 1);
+}
+
+/* save the profile as `<symbol> <calls>' lines in first-use order;
+ * symbols that were never called are omitted */
+GDO_INLINE void _gdo_profile_save(_gdo_profile_t *prof, const char *path)
+{
+    int symbols[GDO_SYMBOL_COUNT];
+    FILE *fp;
+
+    for (int i = 0; i < GDO_SYMBOL_COUNT; i++) {
+        symbols[i] = -1;
+    }
+
+    for (int i = 0; i < GDO_SYMBOL_COUNT; i++) {
+        const long order = GDO_ATOMIC_LOAD_LONG(&prof->order[i]);
+
+        if (order > 0 && order <= GDO_SYMBOL_COUNT) {
+            symbols[order - 1] = i;
+        }
+    }
+
+#ifdef _MSC_VER
+    if (fopen_s(&fp, path, "w") != 0) {
+        return;
+    }
+#else
+    if ((fp = fopen(path, "w")) == NULL) {
+        return;
+    }
+#endif
+
+    fputs("# symbol usage profile in first-use order: <symbol> <calls>\n", fp);
+
+    for (int i = 0; i < GDO_SYMBOL_COUNT; i++) {
+        if (symbols[i] != -1) {
+            fprintf(fp, "%s %ld\n", _gdo_symbol_name(symbols[i]),
+                GDO_ATOMIC_LOAD_LONG(&prof->calls[symbols[i]]));
+        }
+    }
+
+    fclose(fp);
+}
+
+#endif //GDO_RECORD_PROFILE
+
+
 #if !defined(GDO_WINAPI)
 
 GDO_INLINE gdo_hmod_t _gdo_call_dlopen(const char *filename, int flags, bool new_namespace)
@@ -94,93 +367,1362 @@ GDO_INLINE const char *_gdo_aix_parse_ldinfo(struct ld_info *info, uint8_t *sym,
 #endif //_AIX
 
 
+#ifdef GDO_HAVE_DL_ITERATE_PHDR
+
+/* data passed to dl_iterate_phdr() */
+typedef struct _gdo_phdr_query
+{
+    const char *name;           /* look up the program headers of this object */
+    uintptr_t addr;             /* load address of the object */
+    const void *phdr;
+    size_t phnum;
+    long count;                 /* number of loaded objects */
+} _gdo_phdr_query_t;
+
+GDO_INLINE int _gdo_phdr_callback(struct dl_phdr_info *info, size_t size, void *data)
+{
+    _gdo_phdr_query_t *q = (_gdo_phdr_query_t *)data;
+
+    (void)size;
+    q->count++;
+
+    if (q->name && (uintptr_t)info->dlpi_addr == q->addr && info->dlpi_name &&
+        strcmp(info->dlpi_name, q->name) == 0)
+    {
+        q->phdr = info->dlpi_phdr;
+        q->phnum = info->dlpi_phnum;
+    }
+
+    return 0;
+}
+
+#ifdef GDO_HAVE_DLINFO
+/* look up the program headers of a loaded library */
+GDO_INLINE bool _gdo_phdr_query_handle(gdo_hmod_t handle, _gdo_phdr_query_t *q)
+{
+    struct link_map *lm = NULL;
+
+    memset(q, 0, sizeof(*q));
+
+    if (!handle || dlinfo(handle, RTLD_DI_LINKMAP, &lm) == -1 || !lm) {
+        return false;
+    }
+
+    q->name = lm->l_name;
+    q->addr = (uintptr_t)lm->l_addr;
+    dl_iterate_phdr(_gdo_phdr_callback, q);
+
+    return (q->phdr != NULL);
+}
+#endif //GDO_HAVE_DLINFO
+
+#endif //GDO_HAVE_DL_ITERATE_PHDR
+
+
 #if defined(GDO_HAVE_DLINFO) && defined(__linux__)
 
-#include <inttypes.h>
-#include <stdio.h>
+#include <fcntl.h>
 #include <stdlib.h>
 #include <string.h>
-#include <linux/fs.h>
+#include <unistd.h>
+
+
+/* Try to get the full library path from a relative path in the link map.
+ * The path is resolved against the current directory, so the program headers
+ * of the file must match the ones of the loaded object, which are looked up
+ * with dl_iterate_phdr(). */
+GDO_INLINE bool _gdo_fullpath_linkmap(struct link_map *lm, char *buf, size_t bufsize)
+{
+    _gdo_phdr_query_t q;
+    ElfW(Ehdr) ehdr;
+    bool rv = false;
+
+    memset(&q, 0, sizeof(q));
+    q.name = lm->l_name;
+    q.addr = (uintptr_t)lm->l_addr;
+    dl_iterate_phdr(_gdo_phdr_callback, &q);
+
+    if (!q.phdr) {
+        return false;
+    }
+
+    char *path = realpath(lm->l_name, NULL);
+
+    if (!path) {
+        return false;
+    }
+
+    const size_t len = q.phnum * sizeof(ElfW(Phdr));
+    void *phdr = malloc(len);
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+
+    if (phdr && fd != -1 &&
+        pread(fd, &ehdr, sizeof(ehdr), 0) == (ssize_t)sizeof(ehdr) &&
+        ehdr.e_phnum == q.phnum &&
+        ehdr.e_phentsize == sizeof(ElfW(Phdr)) &&
+        pread(fd, phdr, len, (off_t)ehdr.e_phoff) == (ssize_t)len &&
+        memcmp(phdr, q.phdr, len) == 0 &&
+        strlen(path) < bufsize)
+    {
+        strcpy(buf, path);
+        rv = true;
+    }
+
+    if (fd != -1) {
+        close(fd);
+    }
+
+    free(phdr);
+    free(path);
+
+    return rv;
+}
+
+#endif //GDO_HAVE_DLINFO && __linux__
+
 
-#ifdef PROCMAP_QUERY
-# include <fcntl.h>
-# include <sys/ioctl.h>
-# include <unistd.h>
+#ifdef GDO_ENABLE_LOAD_STATS
+
+#ifndef _WIN32
+# include <time.h>
 #endif
 
+/* monotonic clock in nanoseconds */
+GDO_INLINE uint64_t _gdo_time_ns(void)
+{
+#ifdef _WIN32
+    LARGE_INTEGER count, freq;
+
+    QueryPerformanceCounter(&count);
+    QueryPerformanceFrequency(&freq);
+
+    return (uint64_t)(count.QuadPart / freq.QuadPart) * 1000000000u +
+        (uint64_t)(count.QuadPart % freq.QuadPart) * 1000000000u / (uint64_t)freq.QuadPart;
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+#endif
+}
 
-/* try to get the full library path from process map */
-GDO_INLINE bool _gdo_fullpath_procmap(struct link_map *lm, char *buf, size_t bufsize)
+/* number of loaded shared objects; -1 if unknown */
+GDO_INLINE long _gdo_object_count(void)
 {
-#ifdef PROCMAP_QUERY
+#ifdef GDO_HAVE_DL_ITERATE_PHDR
+    _gdo_phdr_query_t q;
 
-    /* use ioctl() to parse /proc/self/maps */
+    memset(&q, 0, sizeof(q));
+    dl_iterate_phdr(_gdo_phdr_callback, &q);
 
-    struct procmap_query q;
+    return q.count;
+#else
+    return -1;
+#endif
+}
 
-    int fd = open("/proc/self/maps", O_RDONLY | O_NONBLOCK);
+/* save statistics of a library load that began at `start' with
+ * `objects' shared objects loaded */
+GDO_INLINE void _gdo_stats_load(gdo_load_stats_t *stats, uint64_t start, long objects)
+{
+    stats->load_time_ns = _gdo_time_ns() - start;
+    stats->new_objects = (objects == -1) ? -1 : _gdo_object_count() - objects;
+}
 
-    if (fd != -1) {
-        memset(&q, 0, sizeof(struct procmap_query));
+/* add a symbol lookup that began at `start'; may be called concurrently */
+GDO_INLINE void _gdo_stats_sym(gdo_load_stats_t *stats, uint64_t start, bool found)
+{
+    GDO_ATOMIC_ADD_U64(&stats->sym_time_ns, _gdo_time_ns() - start);
+    GDO_ATOMIC_ADD_U64(&stats->sym_lookups, 1);
 
-        q.size          = sizeof(struct procmap_query);
-        q.query_flags   = PROCMAP_QUERY_FILE_BACKED_VMA;
-        q.query_addr    = (__u64)lm->l_addr;  /* find this address */
-        q.vma_name_size = bufsize;     /* in: buffer size; out: saved path length + NUL byte */
-        q.vma_name_addr = (__u64)buf;  /* buffer to save pathname */
+    if (!found) {
+        GDO_ATOMIC_ADD_U64(&stats->sym_failed, 1);
+    }
+}
 
-        if (ioctl(fd, PROCMAP_QUERY, &q) == 0 && q.vma_name_size > 0) {
-            close(fd);
-            return true;
-        }
+/* copy statistics */
+GDO_INLINE void _gdo_stats_copy(gdo_load_stats_t *dest, gdo_load_stats_t *src)
+{
+    dest->load_time_ns = src->load_time_ns;
+    dest->new_objects = src->new_objects;
+    dest->huge_text = src->huge_text;
+    dest->sym_time_ns = GDO_ATOMIC_LOAD_U64(&src->sym_time_ns);
+    dest->sym_lookups = GDO_ATOMIC_LOAD_U64(&src->sym_lookups);
+    dest->sym_failed = GDO_ATOMIC_LOAD_U64(&src->sym_failed);
+}
 
-        close(fd);
+#endif //GDO_ENABLE_LOAD_STATS
+
+
+#ifdef GDO_HAVE_PREFETCH
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#define GDO_PREFETCH_MAX_NEEDED  64      /* max. number of prefetched dependencies */
+#define GDO_PREFETCH_MAX_PHNUM   64      /* max. number of program headers */
+#define GDO_PREFETCH_MAX_DYN     1024    /* max. number of dynamic section entries */
+#define GDO_PREFETCH_MAX_STRSZ   (1024*1024)
+#define GDO_PREFETCH_DEFAULT_DIRS  "/lib64:/usr/lib64:/lib:/usr/lib"
+
+
+/* dynamic section entries used to find the dependencies of an ELF file */
+typedef struct _gdo_elf_deps
+{
+    char *strtab;                            /* dynamic string table */
+    size_t needed[GDO_PREFETCH_MAX_NEEDED];  /* DT_NEEDED string offsets */
+    size_t num_needed;
+    const char *rpath;                       /* DT_RPATH (unless there's a DT_RUNPATH) */
+    const char *runpath;                     /* DT_RUNPATH */
+} _gdo_elf_deps_t;
+
+/* data passed to dl_iterate_phdr() when looking up a dependency */
+typedef struct _gdo_prefetch_query
+{
+    const char *name;
+    char *buf;
+    size_t bufsize;
+    int fd;             /* file opened in the directory of a loaded object */
+    bool loaded;        /* an object with the same file name is already loaded */
+} _gdo_prefetch_query_t;
+
+
+/* Read the DT_NEEDED entries and the library search paths from the dynamic
+ * section of an ELF file of the native class. `deps->strtab' must be freed. */
+GDO_INLINE bool _gdo_elf_read_deps(int fd, _gdo_elf_deps_t *deps)
+{
+    ElfW(Ehdr) ehdr;
+    ElfW(Phdr) phdr[GDO_PREFETCH_MAX_PHNUM];
+    const ElfW(Phdr) *pt_dynamic = NULL;
+    ElfW(Addr) strtab = 0;
+    size_t strsz = 0;
+    size_t rpath = (size_t)-1;
+    size_t runpath = (size_t)-1;
+    off_t offset = -1;
+
+    memset(deps, 0, sizeof(*deps));
+
+    if (pread(fd, &ehdr, sizeof(ehdr), 0) != (ssize_t)sizeof(ehdr) ||
+        memcmp(ehdr.e_ident, ELFMAG, SELFMAG) != 0 ||
+        ehdr.e_ident[EI_CLASS] != (sizeof(void *) == 8 ? ELFCLASS64 : ELFCLASS32) ||
+        ehdr.e_phentsize != sizeof(ElfW(Phdr)) ||
+        ehdr.e_phnum == 0 || ehdr.e_phnum > GDO_PREFETCH_MAX_PHNUM)
+    {
+        return false;
     }
 
-    buf[0] = 0;
+    const size_t len = ehdr.e_phnum * sizeof(ElfW(Phdr));
+
+    if (pread(fd, phdr, len, (off_t)ehdr.e_phoff) != (ssize_t)len) {
+        return false;
+    }
 
-#endif //PROCMAP_QUERY
+    for (size_t i = 0; i < ehdr.e_phnum; i++) {
+        if (phdr[i].p_type == PT_DYNAMIC) {
+            pt_dynamic = &phdr[i];
+        }
+    }
 
-    /* use getline() and sscanf() to parse /proc/self/maps */
+    if (!pt_dynamic || pt_dynamic->p_filesz == 0 ||
+        pt_dynamic->p_filesz > GDO_PREFETCH_MAX_DYN * sizeof(ElfW(Dyn)))
+    {
+        return false;
+    }
 
-    FILE *fp = fopen("/proc/self/maps", "r");
+    const size_t ndyn = pt_dynamic->p_filesz / sizeof(ElfW(Dyn));
+    ElfW(Dyn) *dyn = (ElfW(Dyn) *)malloc(ndyn * sizeof(ElfW(Dyn)));
 
-    if (!fp) {
+    if (!dyn || pread(fd, dyn, ndyn * sizeof(ElfW(Dyn)), (off_t)pt_dynamic->p_offset) !=
+                    (ssize_t)(ndyn * sizeof(ElfW(Dyn))))
+    {
+        free(dyn);
         return false;
     }
 
-    uintmax_t start, end;
-    char mode[5];
-    char *line = NULL, *path = NULL;
-    size_t n = 0;
+    for (size_t i = 0; i < ndyn && dyn[i].d_tag != DT_NULL; i++) {
+        switch (dyn[i].d_tag)
+        {
+        case DT_NEEDED:
+            if (deps->num_needed < GDO_PREFETCH_MAX_NEEDED) {
+                deps->needed[deps->num_needed++] = (size_t)dyn[i].d_un.d_val;
+            }
+            break;
+        case DT_STRTAB:
+            strtab = dyn[i].d_un.d_ptr;
+            break;
+        case DT_STRSZ:
+            strsz = (size_t)dyn[i].d_un.d_val;
+            break;
+        case DT_RPATH:
+            rpath = (size_t)dyn[i].d_un.d_val;
+            break;
+        case DT_RUNPATH:
+            runpath = (size_t)dyn[i].d_un.d_val;
+            break;
+        default:
+            break;
+        }
+    }
 
-    while (getline(&line, &n, fp) != -1) {
-        /* address start-end         mode offset   device inode      pathname */
-        /* 7de29d200000-7de29d228000 r--p 00000000 103:01 2758110    /usr/lib/x86_64-linux-gnu/libc.so.6\n */
-        int rv = sscanf(line, "%jx-%jx %4[rwxsp-] %*u %*u:%*u %*u %m[^\n]",
-                        &start, &end, mode, &path);
+    free(dyn);
 
-        if (rv == 4 && lm->l_addr >= start && lm->l_addr < end) {
-            /* match */
+    /* the string table address is not relocated in the file */
+    for (size_t i = 0; i < ehdr.e_phnum; i++) {
+        if (phdr[i].p_type == PT_LOAD && strtab >= phdr[i].p_vaddr &&
+            strtab - phdr[i].p_vaddr < phdr[i].p_filesz)
+        {
+            offset = (off_t)(phdr[i].p_offset + (strtab - phdr[i].p_vaddr));
             break;
         }
+    }
 
-        free(path);
-        path = NULL;
+    if (offset == -1 || strsz == 0 || strsz > GDO_PREFETCH_MAX_STRSZ ||
+        !(deps->strtab = (char *)malloc(strsz + 1)))
+    {
+        return false;
     }
 
-    free(line);
-    fclose(fp);
+    if (pread(fd, deps->strtab, strsz, offset) != (ssize_t)strsz) {
+        free(deps->strtab);
+        deps->strtab = NULL;
+        return false;
+    }
 
-    if (path && (n = strlen(path)) < bufsize) {
-        memcpy(buf, path, n + 1);
-        free(path);
-        return true;
+    deps->strtab[strsz] = 0;
+
+    /* drop entries outside of the string table */
+    size_t n = 0;
+
+    for (size_t i = 0; i < deps->num_needed; i++) {
+        if (deps->needed[i] < strsz) {
+            deps->needed[n++] = deps->needed[i];
+        }
     }
 
-    free(path);
-    return false;
+    deps->num_needed = n;
+
+    /* DT_RPATH is ignored if there's a DT_RUNPATH entry */
+    if (runpath != (size_t)-1) {
+        deps->runpath = (runpath < strsz) ? deps->strtab + runpath : NULL;
+    } else if (rpath < strsz) {
+        deps->rpath = deps->strtab + rpath;
+    }
+
+    return true;
 }
 
-#endif //GDO_HAVE_DLINFO && __linux__
+/* open `name' in a colon-separated list of directories, in which `$ORIGIN'
+ * is replaced with `origin'; the path of the opened file is saved in `buf' */
+GDO_INLINE int _gdo_prefetch_open_in(const char *name, const char *dirs, const char *origin,
+                                     char *buf, size_t bufsize)
+{
+    while (dirs && *dirs) {
+        const char *end = strchr(dirs, ':');
+        const size_t len = end ? (size_t)(end - dirs) : strlen(dirs);
+        int n = -1;
+
+        if (len >= 9 && strncmp(dirs, "${ORIGIN}", 9) == 0) {
+            n = snprintf(buf, bufsize, "%s%.*s/%s", origin, (int)(len - 9), dirs + 9, name);
+        } else if (len >= 7 && strncmp(dirs, "$ORIGIN", 7) == 0) {
+            n = snprintf(buf, bufsize, "%s%.*s/%s", origin, (int)(len - 7), dirs + 7, name);
+        } else if (len > 0) {
+            n = snprintf(buf, bufsize, "%.*s/%s", (int)len, dirs, name);
+        }
+
+        if (n > 0 && (size_t)n < bufsize) {
+            int fd = open(buf, O_RDONLY | O_CLOEXEC);
+
+            if (fd != -1) {
+                return fd;
+            }
+        }
+
+        dirs = end ? end + 1 : NULL;
+    }
+
+    return -1;
+}
+
+/* check if an object with the file name `q->name' is loaded */
+GDO_INLINE int _gdo_prefetch_loaded_callback(struct dl_phdr_info *info, size_t size, void *data)
+{
+    _gdo_prefetch_query_t *q = (_gdo_prefetch_query_t *)data;
+    const char *sep = info->dlpi_name ? strrchr(info->dlpi_name, '/') : NULL;
+
+    (void)size;
+
+    if (sep && strcmp(sep + 1, q->name) == 0) {
+        q->loaded = true;
+    }
+
+    return q->loaded;
+}
+
+/* try to open `q->name' in the directory of a loaded object */
+GDO_INLINE int _gdo_prefetch_dir_callback(struct dl_phdr_info *info, size_t size, void *data)
+{
+    _gdo_prefetch_query_t *q = (_gdo_prefetch_query_t *)data;
+    const char *sep = info->dlpi_name ? strrchr(info->dlpi_name, '/') : NULL;
+
+    (void)size;
+
+    if (sep) {
+        int n = snprintf(q->buf, q->bufsize, "%.*s/%s",
+            (int)(sep - info->dlpi_name), info->dlpi_name, q->name);
+
+        if (n > 0 && (size_t)n < q->bufsize) {
+            q->fd = open(q->buf, O_RDONLY | O_CLOEXEC);
+        }
+    }
+
+    return (q->fd != -1);
+}
+
+/* Open a library, searching roughly in the same order as the dynamic linker.
+ * `origin' is the directory of the object that depends on the library. */
+GDO_INLINE int _gdo_prefetch_find(const char *name, const _gdo_elf_deps_t *deps,
+                                  const char *origin, const char *exe_origin,
+                                  char *buf, size_t bufsize)
+{
+    _gdo_prefetch_query_t q;
+    int fd = -1;
+
+    if (strchr(name, '/')) {
+        int n = snprintf(buf, bufsize, "%s", name);
+        return (n > 0 && (size_t)n < bufsize) ? open(name, O_RDONLY | O_CLOEXEC) : -1;
+    }
+
+    if (deps->rpath) {
+        fd = _gdo_prefetch_open_in(name, deps->rpath, origin, buf, bufsize);
+    }
+
+    if (fd == -1) {
+        fd = _gdo_prefetch_open_in(name, getenv("LD_LIBRARY_PATH"), exe_origin, buf, bufsize);
+    }
+
+    if (fd == -1 && deps->runpath) {
+        fd = _gdo_prefetch_open_in(name, deps->runpath, origin, buf, bufsize);
+    }
+
+    if (fd == -1) {
+        memset(&q, 0, sizeof(q));
+        q.name = name;
+        q.buf = buf;
+        q.bufsize = bufsize;
+        q.fd = -1;
+        dl_iterate_phdr(_gdo_prefetch_dir_callback, &q);
+        fd = q.fd;
+    }
+
+    if (fd == -1) {
+        fd = _gdo_prefetch_open_in(name, GDO_PREFETCH_DEFAULT_DIRS, origin, buf, bufsize);
+    }
+
+    return fd;
+}
+
+/* save the directory of `path' into `buf' */
+GDO_INLINE void _gdo_prefetch_dirname(const char *path, char *buf, size_t bufsize)
+{
+    const char *sep = strrchr(path, '/');
+
+    if (sep) {
+        snprintf(buf, bufsize, "%.*s", (int)(sep - path), path);
+    } else {
+        snprintf(buf, bufsize, ".");
+    }
+}
+
+/* Advise the kernel to read a library and its direct dependencies that
+ * aren't loaded yet into the page cache. Returns false if the library
+ * wasn't found. */
+GDO_INLINE bool _gdo_prefetch(const char *filename)
+{
+    _gdo_elf_deps_t exe, lib;
+    _gdo_prefetch_query_t q;
+    char exe_origin[GDO_BUFLEN], origin[GDO_BUFLEN], path[GDO_BUFLEN];
+
+    ssize_t len = readlink("/proc/self/exe", path, sizeof(path) - 1);
+    path[(len > 0) ? len : 0] = 0;
+    _gdo_prefetch_dirname(path, exe_origin, sizeof(exe_origin));
+
+    /* the search paths of the program are used for the library */
+    memset(&exe, 0, sizeof(exe));
+
+    if (!strchr(filename, '/')) {
+        int exe_fd = open("/proc/self/exe", O_RDONLY | O_CLOEXEC);
+
+        if (exe_fd != -1) {
+            _gdo_elf_read_deps(exe_fd, &exe);
+            close(exe_fd);
+        }
+    }
+
+    int fd = _gdo_prefetch_find(filename, &exe, exe_origin, exe_origin, path, sizeof(path));
+    free(exe.strtab);
+
+    if (fd == -1) {
+        return false;
+    }
+
+    posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+
+    if (_gdo_elf_read_deps(fd, &lib)) {
+        _gdo_prefetch_dirname(path, origin, sizeof(origin));
+
+        for (size_t i = 0; i < lib.num_needed; i++) {
+            memset(&q, 0, sizeof(q));
+            q.name = lib.strtab + lib.needed[i];
+            dl_iterate_phdr(_gdo_prefetch_loaded_callback, &q);
+
+            if (q.loaded) {
+                continue;
+            }
+
+            int dep = _gdo_prefetch_find(q.name, &lib, origin, exe_origin, path, sizeof(path));
+
+            if (dep != -1) {
+                posix_fadvise(dep, 0, 0, POSIX_FADV_WILLNEED);
+                close(dep);
+            }
+        }
+
+        free(lib.strtab);
+    }
+
+    close(fd);
+
+    return true;
+}
+
+/* Remember a library that was prefetched explicitly. `*prefetched' holds a
+ * hash of the filename or 0; a collision only skips an optional prefetch. */
+GDO_INLINE void _gdo_prefetch_mark(long *prefetched, const char *filename)
+{
+    GDO_ATOMIC_STORE_LONG(prefetched, (long)(_gdo_phash(filename, 0) | 1));
+}
+
+/* prefetch a library right before it's loaded unless it was prefetched
+ * explicitly; that is only taken into account for the next load because
+ * the pages may be evicted again later */
+GDO_INLINE void _gdo_prefetch_once(long *prefetched, const char *filename)
+{
+    if (GDO_ATOMIC_LOAD_LONG(prefetched) == (long)(_gdo_phash(filename, 0) | 1)) {
+        GDO_ATOMIC_STORE_LONG(prefetched, 0);
+    } else {
+        _gdo_prefetch(filename);
+    }
+}
+
+/* advise the kernel to read the executable segments of a loaded library
+ * and lock them into memory if GDO_LOCK_TEXT is defined */
+GDO_INLINE void _gdo_prefetch_text(gdo_hmod_t handle)
+{
+#ifdef GDO_HAVE_DLINFO
+    _gdo_phdr_query_t q;
+
+    if (!_gdo_phdr_query_handle(handle, &q)) {
+        return;
+    }
+
+    const ElfW(Phdr) *phdr = (const ElfW(Phdr) *)q.phdr;
+    const uintptr_t pagesize = (uintptr_t)sysconf(_SC_PAGESIZE);
+
+    for (size_t i = 0; i < q.phnum; i++) {
+        if (phdr[i].p_type != PT_LOAD || !(phdr[i].p_flags & PF_X)) {
+            continue;
+        }
+
+        const uintptr_t start = (q.addr + phdr[i].p_vaddr) & ~(pagesize - 1);
+        const uintptr_t end = q.addr + phdr[i].p_vaddr + phdr[i].p_memsz;
+
+        posix_madvise((void *)start, end - start, POSIX_MADV_WILLNEED);
+# ifdef GDO_LOCK_TEXT
+        mlock((const void *)start, end - start);
+# endif
+    }
+#else
+    (void)handle;
+#endif //GDO_HAVE_DLINFO
+}
+
+#endif //GDO_HAVE_PREFETCH
+
+
+#ifdef GDO_HAVE_HUGE_TEXT
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#ifndef MADV_HUGEPAGE
+# define MADV_HUGEPAGE 14
+#endif
+
+
+/* read a short sysfs file */
+GDO_INLINE bool _gdo_read_sysfs(const char *path, char *buf, size_t bufsize)
+{
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+
+    if (fd == -1) {
+        return false;
+    }
+
+    ssize_t n = read(fd, buf, bufsize - 1);
+    close(fd);
+
+    if (n <= 0) {
+        return false;
+    }
+
+    buf[n] = 0;
+
+    return true;
+}
+
+/* size of a transparent huge page; 0 if they are disabled */
+GDO_INLINE size_t _gdo_thp_size(void)
+{
+    char buf[128];
+
+    if (!_gdo_read_sysfs("/sys/kernel/mm/transparent_hugepage/enabled", buf, sizeof(buf)) ||
+        strstr(buf, "[never]"))
+    {
+        return 0;
+    }
+
+    if (!_gdo_read_sysfs("/sys/kernel/mm/transparent_hugepage/hpage_pmd_size", buf, sizeof(buf))) {
+        return 2*1024*1024;
+    }
+
+    const size_t size = (size_t)strtoul(buf, NULL, 10);
+
+    /* must be a power of two */
+    return (size != 0 && (size & (size - 1)) == 0) ? size : 0;
+}
+
+/* Remap the huge page aligned part of the memory from `start' to `end' onto
+ * anonymous memory that is advised to be backed by huge pages. The copy is
+ * prepared in a separate mapping and then moved over the original memory.
+ * Returns the number of remapped bytes. */
+GDO_INLINE size_t _gdo_remap_huge(uintptr_t start, uintptr_t end, size_t hpage, int prot)
+{
+    start = (start + hpage - 1) & ~((uintptr_t)hpage - 1);
+    end &= ~((uintptr_t)hpage - 1);
+
+    if (start >= end) {
+        return 0;
+    }
+
+    const size_t size = end - start;
+
+    /* map an additional huge page to align the copy */
+    uint8_t *map = (uint8_t *)mmap(NULL, size + hpage, PROT_READ | PROT_WRITE,
+                                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if (map == (uint8_t *)MAP_FAILED) {
+        return 0;
+    }
+
+    uint8_t *copy = (uint8_t *)(((uintptr_t)map + hpage - 1) & ~((uintptr_t)hpage - 1));
+    uint8_t *map_end = map + size + hpage;
+
+    if (copy > map) {
+        munmap(map, (size_t)(copy - map));
+    }
+
+    if (copy + size < map_end) {
+        munmap(copy + size, (size_t)(map_end - (copy + size)));
+    }
+
+    if (madvise(copy, size, MADV_HUGEPAGE) == -1) {
+        munmap(copy, size);
+        return 0;
+    }
+
+    memcpy(copy, (const void *)start, size);
+
+    if (mprotect(copy, size, prot) == -1 ||
+        mremap(copy, size, size, MREMAP_MAYMOVE | MREMAP_FIXED, (void *)start) == MAP_FAILED)
+    {
+        munmap(copy, size);
+        return 0;
+    }
+
+    return size;
+}
+
+/* Remap the executable segments of a loaded library onto transparent huge
+ * pages; returns the number of remapped bytes. Fails silently. */
+GDO_INLINE uint64_t _gdo_remap_huge_text(gdo_hmod_t handle)
+{
+    _gdo_phdr_query_t q;
+    uint64_t rv = 0;
+    const size_t hpage = _gdo_thp_size();
+
+    if (hpage == 0 || !_gdo_phdr_query_handle(handle, &q)) {
+        return 0;
+    }
+
+    const ElfW(Phdr) *phdr = (const ElfW(Phdr) *)q.phdr;
+
+    for (size_t i = 0; i < q.phnum; i++) {
+        /* execute-only segments can't be copied */
+        if (phdr[i].p_type != PT_LOAD ||
+            (phdr[i].p_flags & (PF_X | PF_R)) != (PF_X | PF_R))
+        {
+            continue;
+        }
+
+        const int prot = PROT_EXEC | PROT_READ |
+            ((phdr[i].p_flags & PF_W) ? PROT_WRITE : 0);
+        const uintptr_t start = q.addr + phdr[i].p_vaddr;
+
+        rv += _gdo_remap_huge(start, start + phdr[i].p_memsz, hpage, prot);
+    }
+
+    return rv;
+}
+
+#endif //GDO_HAVE_HUGE_TEXT
+
+
+#ifdef GDO_HAVE_LOAD_MEMORY
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+
+/* write all data into a file descriptor */
+GDO_INLINE bool _gdo_write_all(int fd, const void *data, size_t size)
+{
+    const uint8_t *p = (const uint8_t *)data;
+
+    while (size > 0) {
+        ssize_t n = write(fd, p, size);
+
+        if (n == -1 && errno == EINTR) {
+            continue;
+        } else if (n <= 0) {
+            return false;
+        }
+
+        p += n;
+        size -= (size_t)n;
+    }
+
+    return true;
+}
+
+#ifdef GDO_USE_ZLIB
+/* decompress a zlib or gzip stream into a file descriptor */
+GDO_INLINE bool _gdo_inflate_all(int fd, const void *data, size_t size)
+{
+    z_stream strm;
+    uint8_t buf[16*1024];
+    int rv;
+
+    if ((uInt)size != size) {
+        return false;
+    }
+
+    memset(&strm, 0, sizeof(strm));
+
+    /* detect zlib and gzip headers */
+    if (inflateInit2(&strm, 15 + 32) != Z_OK) {
+        return false;
+    }
+
+    strm.next_in = (Bytef *)data;
+    strm.avail_in = (uInt)size;
+
+    do {
+        strm.next_out = buf;
+        strm.avail_out = sizeof(buf);
+        rv = inflate(&strm, Z_NO_FLUSH);
+
+        if ((rv != Z_OK && rv != Z_STREAM_END) ||
+            !_gdo_write_all(fd, buf, sizeof(buf) - strm.avail_out))
+        {
+            break;
+        }
+    } while (rv != Z_STREAM_END);
+
+    inflateEnd(&strm);
+
+    return (rv == Z_STREAM_END);
+}
+#endif //GDO_USE_ZLIB
+
+/**
+ * Write a library image into an anonymous memory file and load it from its
+ * path in `/proc/self/fd'. The dynamic linker identifies loaded libraries by
+ * their path, so the descriptor is saved in `*memfd' and must not be closed
+ * before the library was freed; otherwise a later image could get the same
+ * path. On an error `*errmsg' is set, or left NULL if dlerror() has the message.
+ */
+GDO_INLINE gdo_hmod_t _gdo_dlopen_memory(const void *data, size_t size, int flags, bool new_namespace,
+                                         int *memfd, const char **errmsg)
+{
+    char path[64];
+    bool ok;
+
+    *errmsg = NULL;
+
+    int fd = memfd_create("gdo_library", MFD_CLOEXEC);
+
+    if (fd == -1) {
+        *errmsg = "memfd_create() failed";
+        return NULL;
+    }
+
+    if (size >= 4 && memcmp(data, "\177ELF", 4) == 0) {
+        ok = _gdo_write_all(fd, data, size);
+        *errmsg = "failed to write the library image";
+    } else {
+#ifdef GDO_USE_ZLIB
+        ok = _gdo_inflate_all(fd, data, size);
+        *errmsg = "failed to decompress the library image";
+#else
+        ok = false;
+        *errmsg = "library image is not an ELF file";
+#endif
+    }
+
+    if (!ok) {
+        close(fd);
+        return NULL;
+    }
+
+    *errmsg = NULL;
+    snprintf(path, sizeof(path), "/proc/self/fd/%d", fd);
+
+    gdo_hmod_t handle = _gdo_call_dlopen(path, flags, new_namespace);
+
+    if (!handle) {
+        close(fd);
+        return NULL;
+    }
+
+    *memfd = fd;
+
+    return handle;
+}
+
+/* close the memory file of a freed library */
+GDO_INLINE void _gdo_close_memfd(int *memfd)
+{
+    if (*memfd != -1) {
+        close(*memfd);
+        *memfd = -1;
+    }
+}
+
+#endif //GDO_HAVE_LOAD_MEMORY
+
+
+
+#ifdef GDO_HAVE_ELF_RESOLVER
+
+/* DT_HASH entries are 64 bit wide on these targets; don't use them */
+#if !defined(__s390x__) && !defined(__alpha__)
+# define GDO_HAVE_ELF_SYSV_HASH
+#endif
+
+/* data from the dynamic section of a loaded ELF object */
+typedef struct _gdo_elf_info
+{
+    ElfW(Addr)          base;         /* load address */
+    const ElfW(Sym)    *symtab;       /* .dynsym */
+    const char         *strtab;       /* .dynstr */
+    const ElfW(Versym) *versym;       /* .gnu.version (can be NULL) */
+
+    /* DT_GNU_HASH (preferred) */
+    const ElfW(Addr)   *bloom;        /* bloom filter words */
+    const uint32_t     *buckets;
+    const uint32_t     *chains;
+    uint32_t            nbuckets;     /* 0 if not available */
+    uint32_t            symoffset;    /* index of the first symbol in the hash table */
+    uint32_t            bloom_size;
+    uint32_t            bloom_shift;
+
+    /* DT_HASH */
+    const uint32_t     *sysv_buckets;
+    const uint32_t     *sysv_chains;
+    uint32_t            sysv_nbuckets;  /* 0 if not available */
+} _gdo_elf_info_t;
+
+
+/* Pointers in the dynamic section were either already relocated by the
+ * dynamic linker or are still relative to the load address, depending on
+ * the C library and architecture. */
+GDO_INLINE const void *_gdo_elf_dyn_ptr(const struct link_map *lm, ElfW(Addr) ptr)
+{
+    return (const void *)((ptr < lm->l_addr) ? lm->l_addr + ptr : ptr);
+}
+
+
+/* get the link map of `handle' and read the hash and symbol tables */
+GDO_INLINE bool _gdo_elf_get_info(gdo_hmod_t handle, _gdo_elf_info_t *info)
+{
+    struct link_map *lm = NULL;
+    const ElfW(Dyn) *dyn;
+    const uint32_t *gnu_hash = NULL;
+    const uint32_t *sysv_hash = NULL;
+
+    memset(info, 0, sizeof(_gdo_elf_info_t));
+
+    if (dlinfo(handle, RTLD_DI_LINKMAP, &lm) == -1 || !lm || !lm->l_ld) {
+        return false;
+    }
+
+    for (dyn = lm->l_ld; dyn->d_tag != DT_NULL; dyn++) {
+        switch (dyn->d_tag)
+        {
+        case DT_SYMTAB:
+            info->symtab = (const ElfW(Sym) *)_gdo_elf_dyn_ptr(lm, dyn->d_un.d_ptr);
+            break;
+        case DT_STRTAB:
+            info->strtab = (const char *)_gdo_elf_dyn_ptr(lm, dyn->d_un.d_ptr);
+            break;
+        case DT_VERSYM:
+            info->versym = (const ElfW(Versym) *)_gdo_elf_dyn_ptr(lm, dyn->d_un.d_ptr);
+            break;
+        case DT_GNU_HASH:
+            gnu_hash = (const uint32_t *)_gdo_elf_dyn_ptr(lm, dyn->d_un.d_ptr);
+            break;
+#ifdef GDO_HAVE_ELF_SYSV_HASH
+        case DT_HASH:
+            sysv_hash = (const uint32_t *)_gdo_elf_dyn_ptr(lm, dyn->d_un.d_ptr);
+            break;
+#endif
+        default:
+            break;
+        }
+    }
+
+    if (!info->symtab || !info->strtab) {
+        return false;
+    }
+
+    info->base = lm->l_addr;
+
+    /* bloom_size must be a power of 2 */
+    if (gnu_hash && gnu_hash[0] > 0 && gnu_hash[2] > 0 && (gnu_hash[2] & (gnu_hash[2] - 1)) == 0) {
+        info->nbuckets    = gnu_hash[0];
+        info->symoffset   = gnu_hash[1];
+        info->bloom_size  = gnu_hash[2];
+        info->bloom_shift = gnu_hash[3];
+        info->bloom       = (const ElfW(Addr) *)(gnu_hash + 4);
+        info->buckets     = (const uint32_t *)(info->bloom + info->bloom_size);
+        info->chains      = info->buckets + info->nbuckets;
+        return true;
+    }
+
+    if (sysv_hash && sysv_hash[0] > 0) {
+        info->sysv_nbuckets = sysv_hash[0];
+        info->sysv_buckets  = sysv_hash + 2;
+        info->sysv_chains   = info->sysv_buckets + info->sysv_nbuckets;
+        return true;
+    }
+
+    return false;
+}
+
+
+/* Whether the symbol at `index' can be used without the dynamic linker.
+ * Everything that needs special treatment (undefined, absolute, TLS,
+ * IFUNC and unique symbols, hidden versions) is left to dlsym(). */
+GDO_INLINE bool _gdo_elf_sym_usable(const _gdo_elf_info_t *info, uint32_t index)
+{
+    const ElfW(Sym) *sym = &info->symtab[index];
+    const int type = ELF64_ST_TYPE(sym->st_info);  /* same on ELF32 */
+    const int bind = ELF64_ST_BIND(sym->st_info);
+
+    if (sym->st_shndx == SHN_UNDEF || sym->st_shndx == SHN_ABS || sym->st_value == 0) {
+        return false;
+    }
+
+    if (type != STT_FUNC && type != STT_OBJECT && type != STT_NOTYPE) {
+        return false;
+    }
+
+    if (bind != STB_GLOBAL && bind != STB_WEAK) {
+        return false;
+    }
+
+    if (info->versym && (info->versym[index] & 0x8000) != 0) {
+        /* hidden (non-default) version */
+        return false;
+    }
+
+    return true;
+}
+
+
+/* Look up a symbol in the GNU hash table; returns NULL if not found.
+ * The bloom filter and the hash values are checked before any string is
+ * compared, so most misses never touch the string table. */
+GDO_INLINE void *_gdo_elf_gnu_lookup(const _gdo_elf_info_t *info, const char *name, uint32_t hash)
+{
+    const uint32_t bits = sizeof(ElfW(Addr)) * 8;
+    const ElfW(Addr) word = info->bloom[(hash / bits) & (info->bloom_size - 1)];
+    const ElfW(Addr) mask = ((ElfW(Addr))1 << (hash % bits)) |
+                            ((ElfW(Addr))1 << ((hash >> info->bloom_shift) % bits));
+
+    if ((word & mask) != mask) {
+        return NULL;
+    }
+
+    uint32_t i = info->buckets[hash % info->nbuckets];
+
+    if (i < info->symoffset) {
+        return NULL;
+    }
+
+    for ( ; ; i++) {
+        const uint32_t chain_hash = info->chains[i - info->symoffset];
+
+        if ((hash | 1) == (chain_hash | 1) &&
+            strcmp(name, info->strtab + info->symtab[i].st_name) == 0 &&
+            _gdo_elf_sym_usable(info, i))
+        {
+            return (void *)(info->base + info->symtab[i].st_value);
+        }
+
+        /* end of chain */
+        if ((chain_hash & 1) != 0) {
+            break;
+        }
+    }
+
+    return NULL;
+}
+
+
+/* look up a symbol in the SysV hash table; returns NULL if not found */
+GDO_INLINE void *_gdo_elf_sysv_lookup(const _gdo_elf_info_t *info, const char *name, uint32_t hash)
+{
+    uint32_t i = info->sysv_buckets[hash % info->sysv_nbuckets];
+
+    for ( ; i != STN_UNDEF; i = info->sysv_chains[i]) {
+        if (strcmp(name, info->strtab + info->symtab[i].st_name) == 0 &&
+            _gdo_elf_sym_usable(info, i))
+        {
+            return (void *)(info->base + info->symtab[i].st_value);
+        }
+    }
+
+    return NULL;
+}
+
+
+/* Resolve all symbols in a single pass directly from the hash table of the
+ * loaded object, bypassing dlsym(). Symbols that couldn't be resolved this
+ * way are left untouched (NULL) and must be loaded with dlsym().
+ * The hash values of the symbol names were calculated by gendlopen. */
+GDO_INLINE void _gdo_elf_resolve_all(gdo_hmod_t handle, void *(*slot)(int), _gdo_loaded_t *loaded)
+{
+    static const uint32_t gnu_hashes[GDO_SYMBOL_COUNT] = {
+        %%sym_gnu_hash%%, /* %%symbol%% */
+    };
+#ifdef GDO_HAVE_ELF_SYSV_HASH
+    static const uint32_t sysv_hashes[GDO_SYMBOL_COUNT] = {
+        %%sym_sysv_hash%%, /* %%symbol%% */
+    };
+#endif
+    _gdo_elf_info_t info;
+    void *ptr;
+
+    if (!_gdo_elf_get_info(handle, &info)) {
+        return;
+    }
+
+    for (int i = 0; i < GDO_SYMBOL_COUNT; i++) {
+        /* never overwrite a pointer that may be in use */
+        if (_gdo_get_ptr(slot(i))) {
+            continue;
+        }
+
+        if (info.nbuckets > 0) {
+            ptr = _gdo_elf_gnu_lookup(&info, _gdo_symbol_name(i), gnu_hashes[i]);
+        } else {
+#ifdef GDO_HAVE_ELF_SYSV_HASH
+            ptr = _gdo_elf_sysv_lookup(&info, _gdo_symbol_name(i), sysv_hashes[i]);
+#else
+            ptr = NULL;
+#endif
+        }
+
+        _gdo_store_symbol(loaded, slot(i), i, ptr);
+    }
+}
+
+#endif //GDO_HAVE_ELF_RESOLVER
+
+
+#ifdef GDO_HAVE_SYMBOL_CACHE
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/auxv.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define GDO_CACHE_MAGIC      "GDOCACHE"
+#define GDO_CACHE_VERSION    1
+#define GDO_CACHE_BUILD_ID   64  /* max. build-id size */
+
+/* cache file header; followed by the library path (`path_size' bytes)
+ * and an array of `uint64_t' symbol offsets */
+typedef struct _gdo_cache_header
+{
+    char     magic[8];
+    uint32_t version;
+    uint32_t count;          /* number of symbols */
+    uint32_t pool_hash;      /* hash of all symbol names */
+    uint32_t build_id_size;
+    uint8_t  build_id[GDO_CACHE_BUILD_ID];
+    uint64_t hwcap;          /* IFUNC resolvers may depend on the CPU */
+    uint64_t hwcap2;
+    uint32_t path_size;      /* including NUL and padding to 8 bytes */
+    uint32_t reserved;
+} _gdo_cache_header_t;
+
+/* loaded object as seen by the cache */
+typedef struct _gdo_cache_object
+{
+    ElfW(Addr)        base;
+    const char       *path;
+    const ElfW(Phdr) *phdr;
+    ElfW(Half)        phnum;
+} _gdo_cache_object_t;
+
+
+/* get the load address, path and program headers of `handle' */
+GDO_INLINE bool _gdo_cache_get_object(gdo_hmod_t handle, _gdo_cache_object_t *obj)
+{
+    struct link_map *lm = NULL;
+
+    memset(obj, 0, sizeof(_gdo_cache_object_t));
+
+    if (dlinfo(handle, RTLD_DI_LINKMAP, &lm) == -1 || !lm || lm->l_addr == 0 ||
+        !lm->l_name || lm->l_name[0] == 0)
+    {
+        return false;
+    }
+
+    /* shared libraries map their ELF header at the load address */
+    const ElfW(Ehdr) *ehdr = (const ElfW(Ehdr) *)lm->l_addr;
+
+    if (memcmp(ehdr->e_ident, ELFMAG, SELFMAG) != 0 ||
+        ehdr->e_phentsize != sizeof(ElfW(Phdr)) || ehdr->e_phnum == 0)
+    {
+        return false;
+    }
+
+    obj->base = lm->l_addr;
+    obj->path = lm->l_name;
+    obj->phdr = (const ElfW(Phdr) *)(lm->l_addr + ehdr->e_phoff);
+    obj->phnum = ehdr->e_phnum;
+
+    return true;
+}
+
+
+/* copy the GNU build-id note into `buf'; returns its size or 0 */
+GDO_INLINE uint32_t _gdo_cache_build_id(const _gdo_cache_object_t *obj, uint8_t *buf)
+{
+    for (ElfW(Half) i = 0; i < obj->phnum; i++) {
+        if (obj->phdr[i].p_type != PT_NOTE) {
+            continue;
+        }
+
+        const uint8_t *p = (const uint8_t *)(obj->base + obj->phdr[i].p_vaddr);
+        const uint8_t *end = p + obj->phdr[i].p_memsz;
+
+        while (p + sizeof(ElfW(Nhdr)) <= end) {
+            const ElfW(Nhdr) *note = (const ElfW(Nhdr) *)p;
+            const uint8_t *name = p + sizeof(ElfW(Nhdr));
+            const uint8_t *desc = name + ((note->n_namesz + 3) & ~3u);
+
+            if (note->n_type == NT_GNU_BUILD_ID && note->n_namesz == 4 &&
+                memcmp(name, "GNU", 4) == 0 &&
+                note->n_descsz > 0 && note->n_descsz <= GDO_CACHE_BUILD_ID &&
+                desc + note->n_descsz <= end)
+            {
+                memcpy(buf, desc, note->n_descsz);
+                return note->n_descsz;
+            }
+
+            p = desc + ((note->n_descsz + 3) & ~3u);
+        }
+    }
+
+    return 0;
+}
+
+
+/* fill in the cache header of the currently loaded object */
+GDO_INLINE bool _gdo_cache_init_header(const _gdo_cache_object_t *obj, _gdo_cache_header_t *hdr)
+{
+    memset(hdr, 0, sizeof(_gdo_cache_header_t));
+    memcpy(hdr->magic, GDO_CACHE_MAGIC, sizeof(hdr->magic));
+
+    hdr->version = GDO_CACHE_VERSION;
+    hdr->count = GDO_SYMBOL_COUNT;
+    hdr->pool_hash = GDO_SYMBOL_POOL_HASH;
+    hdr->build_id_size = _gdo_cache_build_id(obj, hdr->build_id);
+    hdr->hwcap = getauxval(AT_HWCAP);
+#ifdef AT_HWCAP2
+    hdr->hwcap2 = getauxval(AT_HWCAP2);
+#endif
+    hdr->path_size = (uint32_t)((strlen(obj->path) + 1 + 7) & ~(size_t)7);
+
+    /* without a build-id we can't tell if the library has changed */
+    return (hdr->build_id_size > 0);
+}
+
+
+/* whether `offset' lies within a loadable segment of the object */
+GDO_INLINE bool _gdo_cache_offset_ok(const _gdo_cache_object_t *obj, uint64_t offset)
+{
+    for (ElfW(Half) i = 0; i < obj->phnum; i++) {
+        const ElfW(Phdr) *ph = &obj->phdr[i];
+
+        if (ph->p_type == PT_LOAD && offset >= ph->p_vaddr && offset < ph->p_vaddr + ph->p_memsz) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+/* Set all symbol pointers from the cache file.
+ * Returns false if there's no valid cache file, in which case no
+ * pointers were changed. */
+GDO_INLINE bool _gdo_symbol_cache_load(gdo_hmod_t handle, void *(*slot)(int), _gdo_loaded_t *loaded)
+{
+    _gdo_cache_object_t obj;
+    _gdo_cache_header_t hdr;
+    struct stat st;
+    bool rv = false;
+
+    if (!_gdo_cache_get_object(handle, &obj) || !_gdo_cache_init_header(&obj, &hdr)) {
+        return false;
+    }
+
+    const size_t size = sizeof(hdr) + hdr.path_size + GDO_SYMBOL_COUNT * sizeof(uint64_t);
+    int fd = open(GDO_SYMBOL_CACHE, O_RDONLY | O_CLOEXEC);
+
+    if (fd == -1) {
+        return false;
+    }
+
+    if (fstat(fd, &st) == -1 || (size_t)st.st_size != size) {
+        close(fd);
+        return false;
+    }
+
+    void *map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (map == MAP_FAILED) {
+        return false;
+    }
+
+    const char *path = (const char *)map + sizeof(hdr);
+    const uint64_t *offsets = (const uint64_t *)(path + hdr.path_size);
+
+    /* validate header, path and all offsets before anything is changed */
+    if (memcmp(map, &hdr, sizeof(hdr)) == 0 &&
+        strncmp(path, obj.path, hdr.path_size) == 0)
+    {
+        rv = true;
+
+        for (int i = 0; i < GDO_SYMBOL_COUNT; i++) {
+            if (!_gdo_cache_offset_ok(&obj, offsets[i])) {
+                rv = false;
+                break;
+            }
+        }
+
+        for (int i = 0; rv && i < GDO_SYMBOL_COUNT; i++) {
+            /* never overwrite a pointer that may be in use */
+            if (!_gdo_get_ptr(slot(i))) {
+                _gdo_store_symbol(loaded, slot(i), i, (void *)(obj.base + offsets[i]));
+            }
+        }
+    }
+
+    munmap(map, size);
+
+    return rv;
+}
+
+
+/* Save the offsets of all loaded symbols into the cache file.
+ * Nothing is saved if a symbol lies outside of the library
+ * (i.e. it was provided by a dependency). Errors are ignored. */
+GDO_INLINE void _gdo_symbol_cache_save(gdo_hmod_t handle, void *(*slot)(int))
+{
+    _gdo_cache_object_t obj;
+    _gdo_cache_header_t hdr;
+    char tmp[] = GDO_SYMBOL_CACHE ".XXXXXX";
+
+    if (!_gdo_cache_get_object(handle, &obj) || !_gdo_cache_init_header(&obj, &hdr)) {
+        return;
+    }
+
+    const size_t size = sizeof(hdr) + hdr.path_size + GDO_SYMBOL_COUNT * sizeof(uint64_t);
+    uint8_t *buf = (uint8_t *)calloc(1, size);
+
+    if (!buf) {
+        return;
+    }
+
+    uint64_t *offsets = (uint64_t *)(buf + sizeof(hdr) + hdr.path_size);
+
+    memcpy(buf, &hdr, sizeof(hdr));
+    memcpy(buf + sizeof(hdr), obj.path, strlen(obj.path));
+
+    for (int i = 0; i < GDO_SYMBOL_COUNT; i++) {
+        offsets[i] = (uint64_t)((ElfW(Addr))_gdo_get_ptr(slot(i)) - obj.base);
+
+        if (!_gdo_cache_offset_ok(&obj, offsets[i])) {
+            free(buf);
+            return;
+        }
+    }
+
+    /* write into a temporary file first and rename it, so other
+     * processes never see an incomplete cache file */
+    int fd = mkstemp(tmp);
+
+    if (fd != -1) {
+        bool ok = (write(fd, buf, size) == (ssize_t)size);
+        ok = (close(fd) == 0 && ok);
+
+        if (!ok || rename(tmp, GDO_SYMBOL_CACHE) != 0) {
+            unlink(tmp);
+        }
+    }
+
+    free(buf);
+}
 
+#endif //GDO_HAVE_SYMBOL_CACHE
@@ -25,6 +25,97 @@ GDO_ENABLE_AUTOLOAD_LAZY
     Same as GDO_ENABLE_AUTOLOAD but only the requested symbol is loaded when its
     wrapper function is called instead of all symbols.
 
+    Auto-loading is thread-safe: a single thread loads the library and symbols
+    while others wait for it. Once a symbol was loaded its wrapper function only
+    does an atomic load and a branch before calling it.
+
+GDO_ENABLE_AUTOLOAD_BACKGROUND
+    Same as GDO_ENABLE_AUTOLOAD_LAZY but once the library was auto-loaded the
+    symbols listed in GDO_CRITICAL_SYMBOLS are loaded right away and all other
+    symbols are loaded on a background thread. Wrapper functions never wait for
+    the background thread: a symbol that wasn't loaded yet is loaded by the
+    wrapper function itself. Freeing the library stops the background thread.
+    The program must be linked against the threads library (C only).
+
+GDO_ENABLE_IDLE_UNLOAD
+    Together with GDO_ENABLE_AUTOLOAD (GCC/Clang only): free the auto-loaded
+    library after it wasn't used for GDO_IDLE_TIMEOUT milliseconds, i.e. in
+    long-running services that only need a large library from time to time.
+    Each wrapper function call holds a reference on the library, which is
+    released when the wrapper function returns. A thread that is started when
+    the library was auto-loaded calls `gdo_free_lib()' once no references are
+    held and no wrapper function was called for at least one full timeout
+    period, so the library is freed 1 to 2 timeouts after its last use. The
+    next call of a wrapper function loads it again. Only calls through the
+    wrapper functions are tracked: symbol pointers and objects of the library
+    must not be kept and used outside of them. Lazy binding and IFUNC wrappers
+    are disabled. Wrapper functions that must be implemented as macros
+    (variable arguments without `__builtin_va_arg_pack()') keep the library
+    loaded once they were called. The program must be linked against the
+    threads library (C only).
+
+GDO_ENABLE_LAZY_BINDING
+    If defined together with GDO_WRAP_FUNCTIONS or GDO_ENABLE_AUTOLOAD each
+    wrapper function calls its symbol through a pointer that initially points
+    to a resolver stub. On the first call the stub loads the symbol (or fails
+    the same way a wrapper function would), replaces the pointer and calls
+    the symbol. Every later call is a plain indirect call without any checks.
+    Functions with variable arguments or a hook macro are not lazy bound.
+
+GDO_ENABLE_ASYNC_LOADING
+    Add functions to load the library (and optionally all symbols) on a
+    background thread: `gdo_load_lib_async()' and `gdo_wait_loaded()' in C,
+    `load_async()' and `wait_loaded()' in C++. Wrapper functions that are
+    called while the load is pending wait for it to finish.
+    The program must be linked against the threads library (i.e. `-pthread').
+
+GDO_ENABLE_LOAD_STATS
+    Collect load diagnostics: the wall time and the number of newly mapped
+    shared objects of the last library load, and the total time, number and
+    failures of symbol lookups with `dlsym()'. The size of the code that was
+    remapped by GDO_REMAP_HUGE_TEXT is reported too. They are retrieved with
+    `gdo_get_load_stats()' in C or `load_stats()' in C++. New shared objects
+    are counted with `dl_iterate_phdr()'; on other systems the count is -1.
+
+GDO_ENABLE_LOAD_MEMORY
+    Linux only: add `gdo_load_lib_memory()' in C or `load_memory()' in C++ to
+    load a library image from memory through an anonymous memory file. This is
+    enabled by default if a library was embedded with `-embed'.
+
+GDO_PREFETCH
+    Linux only: warm up the page cache before a library is loaded. The library
+    file is looked up the way the dynamic linker would (roughly: RUNPATH with
+    $ORIGIN, LD_LIBRARY_PATH, the directories of loaded objects and the default
+    directories) and the kernel is advised to read it and its direct
+    dependencies that aren't loaded yet with `posix_fadvise(POSIX_FADV_WILLNEED)'.
+    Once the library was mapped the same advice is given for its executable
+    segments with `posix_madvise()'. The file prefetch is also available as
+    `gdo_prefetch()' in C or `prefetch()' in C++, which can be called early
+    (i.e. on a helper thread at startup) to load the library later without
+    waiting for the disk. The next load of a library that was prefetched this
+    way doesn't look up and read its files again.
+
+GDO_LOCK_TEXT
+    Together with GDO_PREFETCH: lock the executable segments of a loaded library
+    into memory with `mlock()' so they are never paged out. Errors (i.e. from
+    exceeding RLIMIT_MEMLOCK) are ignored.
+
+GDO_REMAP_HUGE_TEXT
+    Linux only: after a library was loaded, copy the parts of its executable
+    segments that are aligned to the size of a huge page onto anonymous memory
+    backed by transparent huge pages to reduce iTLB misses. The copy is moved
+    over the original mapping with `mremap()', so the code stays accessible
+    the whole time. Nothing is done if transparent huge pages are disabled, if
+    a segment is smaller than a huge page or if it isn't readable. The number of remapped bytes is
+    reported in the load diagnostics. Tools that resolve code addresses from
+    the file mapping (i.e. `perf') won't recognize the remapped code anymore.
+    With `-library-map' only the main library is remapped.
+
+GDO_USE_ZLIB
+    Allow `gdo_load_lib_memory()' (C) and `load_memory()' (C++) to load zlib
+    or gzip compressed library images (see GDO_ENABLE_LOAD_MEMORY). The program
+    must be linked against zlib (i.e. `-lz').
+
 GDO_USE_MESSAGE_BOX
     Windows only: if GDO_ENABLE_AUTOLOAD was activated this will enable
     error messages from auto-loading to be displayed in MessageBox windows.
@@ -36,6 +127,31 @@ GDO_CONVERT_FILENAME
 GDO_DISABLE_ALIASING
     Don't use preprocessor macros to alias symbol names.
 
+GDO_DISABLE_PARALLEL_LOADING
+    If the header was created with `-library-map' the libraries of the map are
+    loaded on threads of their own while the main library is loaded on the
+    calling thread, so the program must be linked against the threads library.
+    Define this macro to load them one after another on the calling thread.
+
+GDO_USE_ELF_RESOLVER
+    Linux only: when loading all symbols, look them up directly in the
+    library's ELF `.gnu.hash' and `.dynsym' tables in a single pass instead
+    of calling `dlsym()' for each symbol. Symbols that can't be resolved this
+    way (i.e. IFUNC, TLS or versioned symbols, or symbols provided by a
+    dependency) are still loaded with `dlsym()'. Not used with `-library-map'.
+
+GDO_USE_IFUNC
+    ELF only (GCC/Clang): if GDO_WRAP_VISIBILITY is defined the exported
+    wrapper functions are emitted as GNU indirect functions (IFUNC). A caller
+    that is bound to a wrapper function after its symbol was loaded (i.e. with
+    lazy binding on the first call, or with `dlsym()') is bound directly to
+    the loaded symbol, without any wrapper code in between. Otherwise it is
+    bound to the regular wrapper function. The IFUNC resolvers never load
+    anything themselves, because the dynamic linker may run them while it
+    relocates objects (LD_BIND_NOW or `-z now'), before any constructors.
+    Functions with variable arguments or a hook macro are not affected.
+    The library must not be freed once a caller was bound to its symbols.
+
 GDO_DISABLE_WARNINGS
     Mute diagnostic warnings.
 
@@ -48,6 +164,33 @@ GDO_DEFAULT_FLAGS
 GDO_DEFAULT_LIB
     Set a default library name through this macro.
 
+GDO_CRITICAL_SYMBOLS
+    Comma-separated list of GDO_LOAD_<symbol> values that are loaded in this
+    order right after the library was auto-loaded by GDO_ENABLE_AUTOLOAD_LAZY
+    (and before the background thread of GDO_ENABLE_AUTOLOAD_BACKGROUND is
+    started). If the header was created with `-profile' it defaults to all
+    symbols listed in the profile, in the same order.
+
+GDO_IDLE_TIMEOUT
+    Idle timeout in milliseconds of GDO_ENABLE_IDLE_UNLOAD. The default is
+    30000 (30 seconds).
+
+GDO_SYMBOL_CACHE
+    Linux only: path of a symbol cache file. After all symbols were loaded
+    successfully their offsets from the library load address are saved into
+    this file, together with the library's ELF build-id and path. The next
+    time all symbols are loaded the pointers are taken from the memory-mapped
+    cache file without any `dlsym()' calls. A cache file that doesn't match
+    the library, the list of symbols or the CPU is ignored and overwritten.
+    Not used with `-library-map'.
+
+GDO_RECORD_PROFILE
+    Instrumentation: path of a symbol usage profile that is written when the
+    program exits. Each call of a wrapper function is counted and the called
+    symbols are saved as `<symbol> <calls>' lines in the order in which they
+    were first called. Pass the file to `-profile' to generate a loader that
+    loads these symbols eagerly. Lazy binding and IFUNC wrappers are disabled.
+
 GDO_WRAP_VISIBILITY
     Set the symbol visibility of wrapped functions. By default wrapped functions
     are not visible and inlined.
@@ -99,6 +242,10 @@ GDO_HOOK_<function>(...)
 # include <dlfcn.h>
 #endif
 
+#ifndef _WIN32
+# include <sched.h>  /* sched_yield() */
+#endif
+
 
 #ifdef GDO_WINAPI
 typedef HMODULE gdo_hmod_t;
@@ -194,6 +341,109 @@ extern int dladdr(const void *addr, Dl_info *info);
 extern int dlinfo(void *handle, int request, void *info);
 #endif
 
+/* dl_iterate_phdr(3) */
+#if !defined(GDO_HAVE_DL_ITERATE_PHDR) && \
+    (defined(__linux__) || \
+     defined(__FreeBSD__) || \
+     defined(__NetBSD__) || \
+     defined(__OpenBSD__) || \
+     defined(__DragonFly__) || \
+     defined(__sun))
+# define GDO_HAVE_DL_ITERATE_PHDR
+#endif
+
+#ifdef GDO_HAVE_DL_ITERATE_PHDR
+# include <link.h> /* dl_iterate_phdr() */
+# if !defined(_GNU_SOURCE) && defined(__GLIBC__)
+#  define GDO_NEED_DL_ITERATE_PHDR_PROTO
+# endif
+#endif
+
+#if !defined(DL_ITERATE_PHDR_PROTOTYPE) && defined(GDO_NEED_DL_ITERATE_PHDR_PROTO)
+# define DL_ITERATE_PHDR_PROTOTYPE
+/* only the first members are used */
+struct dl_phdr_info {
+  ElfW(Addr)        dlpi_addr;
+  const char       *dlpi_name;
+  const ElfW(Phdr) *dlpi_phdr;
+  ElfW(Half)        dlpi_phnum;
+};
+extern int dl_iterate_phdr(int (*callback)(struct dl_phdr_info *info, size_t size, void *data), void *data);
+#endif
+
+/* page cache prefetching */
+#if defined(GDO_PREFETCH) && defined(__linux__) && defined(GDO_HAVE_DL_ITERATE_PHDR)
+# define GDO_HAVE_PREFETCH
+#endif
+
+/* remap the text segment onto transparent huge pages; requires the link map */
+#if defined(GDO_REMAP_HUGE_TEXT) && defined(__linux__) && \
+    defined(GDO_HAVE_DLINFO) && defined(GDO_HAVE_DL_ITERATE_PHDR)
+# define GDO_HAVE_HUGE_TEXT
+# include <sys/mman.h>
+# if !defined(_GNU_SOURCE) && defined(__GLIBC__)
+#  define GDO_NEED_MREMAP_PROTO
+# endif
+#endif
+
+#if !defined(MREMAP_PROTOTYPE) && defined(GDO_NEED_MREMAP_PROTO)
+# define MREMAP_PROTOTYPE
+# ifndef MREMAP_MAYMOVE
+#  define MREMAP_MAYMOVE 1
+# endif
+# ifndef MREMAP_FIXED
+#  define MREMAP_FIXED 2
+# endif
+extern void *mremap(void *old_address, size_t old_size, size_t new_size, int flags, ...);
+#endif
+
+/* load a library from memory with memfd_create(2); Glibc 2.27 or later */
+#if (defined(GDO_ENABLE_LOAD_MEMORY) || defined(GDO_EMBEDDED_LIB_DATA)) && \
+    defined(__linux__) && !defined(GDO_WINAPI) && \
+    (!defined(__GLIBC__) || __GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 27))
+# define GDO_HAVE_LOAD_MEMORY
+# include <sys/mman.h>
+# ifndef _GNU_SOURCE
+#  define GDO_NEED_MEMFD_CREATE_PROTO
+# endif
+# ifdef GDO_USE_ZLIB
+#  include <zlib.h>
+# endif
+#endif
+
+#if !defined(MEMFD_CREATE_PROTOTYPE) && defined(GDO_NEED_MEMFD_CREATE_PROTO)
+# define MEMFD_CREATE_PROTOTYPE
+# ifndef MFD_CLOEXEC
+#  define MFD_CLOEXEC 1U
+# endif
+extern int memfd_create(const char *name, unsigned int flags);
+#endif
+
+/* symbol cache file; requires the link map of a single library */
+#if defined(GDO_SYMBOL_CACHE) && defined(GDO_HAVE_DLINFO) && defined(__linux__) && \
+    !defined(GDO_LIBRARY_COUNT)
+# define GDO_HAVE_SYMBOL_CACHE
+#endif
+
+/* resolve symbols from the ELF hash table; requires the link map of a single library */
+#if defined(GDO_USE_ELF_RESOLVER) && defined(GDO_HAVE_DLINFO) && \
+    defined(__linux__) && defined(DT_GNU_HASH) && !defined(GDO_LIBRARY_COUNT)
+# define GDO_HAVE_ELF_RESOLVER
+#endif
+
+/* load the libraries of a library map on threads */
+#if defined(GDO_LIBRARY_COUNT) && !defined(GDO_DISABLE_PARALLEL_LOADING)
+# define GDO_HAVE_PARALLEL_LOADING
+#endif
+
+
+/* export wrapper functions as GNU indirect functions */
+#if defined(GDO_USE_IFUNC) && defined(GDO_WRAP_VISIBILITY) && \
+    defined(__GNUC__) && defined(__ELF__) && !defined(__cplusplus) && \
+    !defined(GDO_RECORD_PROFILE) && !defined(GDO_ENABLE_IDLE_UNLOAD)
+# define GDO_HAVE_IFUNC
+#endif
+
 
 /* dlmopen(3); only on Glibc and Solaris/IllumOS */
 #if !defined(GDO_HAVE_DLMOPEN) && \
@@ -224,6 +474,90 @@ extern void *dlmopen(Lmid_t lmid, const char *path, int flags);
 #endif
 
 
+/* Atomic operations on symbol pointers, the loaded symbols bitmap and the
+ * auto-loading lock. Pointers are loaded with acquire and stored with release
+ * semantics, which on x86 are regular moves. */
+#ifdef __GNUC__
+# define GDO_ATOMIC_LOAD_PTR(PTR)       __atomic_load_n((void **)(PTR), __ATOMIC_ACQUIRE)
+# define GDO_ATOMIC_STORE_PTR(PTR, VAL) __atomic_store_n((void **)(PTR), (VAL), __ATOMIC_RELEASE)
+# define GDO_ATOMIC_LOAD_LONG(PTR)      __atomic_load_n((PTR), __ATOMIC_ACQUIRE)
+# define GDO_ATOMIC_STORE_LONG(PTR, VAL) __atomic_store_n((PTR), (VAL), __ATOMIC_RELEASE)
+# define GDO_ATOMIC_INCREMENT(PTR)      __atomic_add_fetch((PTR), 1, __ATOMIC_RELEASE)
+# define GDO_ATOMIC_LOAD_U32(PTR)       __atomic_load_n((PTR), __ATOMIC_ACQUIRE)
+# define GDO_ATOMIC_ADD_U64(PTR, VAL)   __atomic_add_fetch((PTR), (VAL), __ATOMIC_RELAXED)
+# define GDO_ATOMIC_LOAD_U64(PTR)       __atomic_load_n((PTR), __ATOMIC_RELAXED)
+# define GDO_ATOMIC_FETCH_OR(PTR, VAL)  __atomic_fetch_or((PTR), (VAL), __ATOMIC_RELAXED)
+# define GDO_ATOMIC_TRYLOCK(PTR)        (__atomic_exchange_n((PTR), 1, __ATOMIC_ACQUIRE) == 0)
+# define GDO_ATOMIC_UNLOCK(PTR)         __atomic_store_n((PTR), 0, __ATOMIC_RELEASE)
+# define GDO_UNLIKELY(x)                __builtin_expect(!!(x), 0)
+#elif defined(_MSC_VER)
+# define GDO_ATOMIC_LOAD_PTR(PTR)       ReadPointerAcquire((void * const volatile *)(PTR))
+# define GDO_ATOMIC_STORE_PTR(PTR, VAL) WritePointerRelease((void * volatile *)(PTR), (VAL))
+# define GDO_ATOMIC_LOAD_LONG(PTR)      ReadAcquire((PTR))
+# define GDO_ATOMIC_STORE_LONG(PTR, VAL) WriteRelease((PTR), (VAL))
+# define GDO_ATOMIC_INCREMENT(PTR)      InterlockedIncrementRelease((PTR))
+# define GDO_ATOMIC_LOAD_U32(PTR)       ((uint32_t)ReadAcquire((LONG const volatile *)(PTR)))
+# define GDO_ATOMIC_ADD_U64(PTR, VAL)   InterlockedAdd64((LONG64 volatile *)(PTR), (LONG64)(VAL))
+# define GDO_ATOMIC_LOAD_U64(PTR)       ((uint64_t)InterlockedCompareExchange64((LONG64 volatile *)(PTR), 0, 0))
+# define GDO_ATOMIC_FETCH_OR(PTR, VAL)  ((uint32_t)InterlockedOrNoFence((volatile LONG *)(PTR), (LONG)(VAL)))
+# define GDO_ATOMIC_TRYLOCK(PTR)        (InterlockedExchangeAcquire((PTR), 1) == 0)
+# define GDO_ATOMIC_UNLOCK(PTR)         WriteRelease((PTR), 0)
+# define GDO_UNLIKELY(x)                (x)
+#else
+/* not thread-safe */
+# define GDO_ATOMIC_LOAD_PTR(PTR)       (*(void **)(PTR))
+# define GDO_ATOMIC_STORE_PTR(PTR, VAL) (*(void **)(PTR) = (VAL))
+# define GDO_ATOMIC_LOAD_LONG(PTR)      (*(PTR))
+# define GDO_ATOMIC_STORE_LONG(PTR, VAL) (*(PTR) = (VAL))
+# define GDO_ATOMIC_INCREMENT(PTR)      (++*(PTR))
+# define GDO_ATOMIC_LOAD_U32(PTR)       (*(PTR))
+# define GDO_ATOMIC_ADD_U64(PTR, VAL)   (*(PTR) += (VAL))
+# define GDO_ATOMIC_LOAD_U64(PTR)       (*(PTR))
+# define GDO_ATOMIC_FETCH_OR(PTR, VAL)  ((*(PTR) & (VAL)) ? (VAL) : ((*(PTR) |= (VAL)), 0))
+# define GDO_ATOMIC_TRYLOCK(PTR)        (*(PTR) == 0 ? (*(PTR) = 1) : 0)
+# define GDO_ATOMIC_UNLOCK(PTR)         (*(PTR) = 0)
+# define GDO_UNLIKELY(x)                (x)
+#endif
+
+
+/* load diagnostics (GDO_ENABLE_LOAD_STATS) */
+#ifdef GDO_ENABLE_LOAD_STATS
+typedef struct gdo_load_stats
+{
+    uint64_t load_time_ns;  /* wall time of the last library load */
+    long new_objects;       /* shared objects mapped by the last load, -1 if unknown */
+    uint64_t sym_time_ns;   /* total time spent in symbol lookups */
+    uint64_t sym_lookups;   /* number of symbol lookups */
+    uint64_t sym_failed;    /* number of failed symbol lookups */
+    uint64_t huge_text;     /* bytes of code remapped onto huge pages by the last load */
+} gdo_load_stats_t;
+#endif
+
+
+/* align data to a cache line */
+#ifdef __GNUC__
+# define GDO_CACHELINE_ALIGNED  __attribute__ ((aligned (64)))
+#elif defined(_MSC_VER)
+# define GDO_CACHELINE_ALIGNED  __declspec(align(64))
+#else
+# define GDO_CACHELINE_ALIGNED  /**/
+#endif
+
+
+/* thread-local storage */
+#if defined(__cplusplus) && (__cplusplus >= 201103L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201103L))
+# define GDO_THREAD_LOCAL  thread_local
+#elif defined(__GNUC__)
+# define GDO_THREAD_LOCAL  __thread
+#elif defined(_MSC_VER)
+# define GDO_THREAD_LOCAL  __declspec(thread)
+#elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+# define GDO_THREAD_LOCAL  _Thread_local
+#else
+# define GDO_THREAD_LOCAL  /* not thread-safe */
+#endif
+
+
 /* set visibility of wrapped functions */
 #ifdef GDO_WRAP_VISIBILITY
 /* visible as regular functions */
@@ -236,6 +570,30 @@ extern void *dlmopen(Lmid_t lmid, const char *path, int flags);
 #endif
 
 
+/* hot/cold attributes of wrapped functions, set from a profile (`-profile') */
+#if defined(__GNUC__) && defined(__has_attribute)
+# if __has_attribute(hot) && defined(GDO_WRAP_VISIBILITY)
+#  define GDO_WRAP_HOT   __attribute__ ((hot))
+# elif __has_attribute(hot)
+#  define GDO_WRAP_HOT   __attribute__ ((hot, always_inline))
+# endif
+# if __has_attribute(cold)
+#  define GDO_WRAP_COLD  __attribute__ ((cold))
+# endif
+#endif
+#ifndef GDO_WRAP_HOT
+# define GDO_WRAP_HOT   /**/
+#endif
+#ifndef GDO_WRAP_COLD
+# define GDO_WRAP_COLD  /**/
+#endif
+#ifdef GDO_HAVE_PROFILE
+# define GDO_WRAP_ATTR(x)  GDO_WRAP_ATTR_##x
+#else
+# define GDO_WRAP_ATTR(x)  /**/
+#endif
+
+
 /* diagnostic #pragma warnings */
 #ifdef __GNUC__
 # define _GDO_PRAGMA(x)    _Pragma(#x)
@@ -282,6 +640,13 @@ extern void *dlmopen(Lmid_t lmid, const char *path, int flags);
 # endif
 #endif
 
+/* filenames of the libraries of a library map */
+#ifdef _GDO_TARGET_WIDECHAR
+# define GDO_LIBRARY_FILENAME(NAME)  GDO_HARDCODED_LIBRARY_##NAME##W
+#else
+# define GDO_LIBRARY_FILENAME(NAME)  GDO_HARDCODED_LIBRARY_##NAME##A
+#endif
+
 
 /* dlopen(3) flags for compatibility with LoadLibrary()
  * taken from different implementations of dlfcn.h */
@@ -396,11 +761,32 @@ extern void *dlmopen(Lmid_t lmid, const char *path, int flags);
 #endif
 
 
+/* background loading is done on top of "lazy autoload" */
+#if defined(GDO_ENABLE_AUTOLOAD_BACKGROUND) && !defined(GDO_ENABLE_AUTOLOAD_LAZY)
+# define GDO_ENABLE_AUTOLOAD_LAZY
+#endif
+
+/* symbols to load eagerly with "lazy autoload"; default to the profile */
+#if !defined(GDO_CRITICAL_SYMBOLS) && defined(GDO_PROFILE_SYMBOLS)
+# define GDO_CRITICAL_SYMBOLS GDO_PROFILE_SYMBOLS
+#elif !defined(GDO_CRITICAL_SYMBOLS)
+# define GDO_CRITICAL_SYMBOLS -1
+#endif
+
 /* always enable autoload if "lazy autoload" was enabled */
 #if defined(GDO_ENABLE_AUTOLOAD_LAZY) && !defined(GDO_ENABLE_AUTOLOAD)
 # define GDO_ENABLE_AUTOLOAD
 #endif
 
+/* free an idle auto-loaded library; wrapper functions release their
+ * reference with the `cleanup' attribute */
+#if defined(GDO_ENABLE_IDLE_UNLOAD) && defined(GDO_ENABLE_AUTOLOAD) && defined(__GNUC__)
+# define GDO_HAVE_IDLE_UNLOAD
+# ifndef GDO_IDLE_TIMEOUT
+#  define GDO_IDLE_TIMEOUT 30000
+# endif
+#endif
+
 
 /* whether wrapped functions can be used */
 %PARAM_SKIP_REMOVE_BEGIN%
@@ -0,0 +1,302 @@
+/*****************************************************************************/
+/*                        C context API implementation                       */
+/*****************************************************************************/
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* linkage */
+#ifdef GDO_STATIC
+# define GDO_LINKAGE  static inline
+#else
+# define GDO_LINKAGE  /**/
+#endif
+
+#ifdef _GDO_TARGET_WIDECHAR
+# define GDO_XHS  L"%hs"  /* narrow character string */
+#else
+# define GDO_XHS  "%s"
+#endif
+
+
+/* offsets of the symbol pointers in the table, in the same order
+ * as the symbol names; this doesn't need any relocations */
+static const size_t _gdo_ctx_offsets[GDO_SYMBOL_COUNT] = {
+    offsetof(gdo_api_t, GDO_PTR_%%symbol%%),
+};
+
+
+#ifdef GDO_WINAPI
+/* save the last system error code */
+# define _GDO_CTX_SAVE_ERROR(CTX, FMT, NAME) \
+    _sntprintf_s((CTX)->errbuf, GDO_CTX_ERRLEN, _TRUNCATE, FMT _T(": error code %lu"), \
+        NAME, (unsigned long)GetLastError())
+#else
+/* save the last message provided by dlerror() */
+# define _GDO_CTX_SAVE_ERROR(CTX, FMT, NAME) \
+    _gdo_ctx_save_dlerror(CTX, NAME)
+
+GDO_INLINE void _gdo_ctx_save_dlerror(gdo_ctx_t *ctx, const char *name)
+{
+    const char *msg = dlerror();
+    snprintf(ctx->errbuf, GDO_CTX_ERRLEN, "%s", msg ? msg : name);
+}
+#endif
+
+
+/* load library and symbols into a context */
+GDO_LINKAGE bool gdo_ctx_load(gdo_ctx_t *ctx, const gdo_char_t *filename, int flags, bool new_namespace)
+{
+    memset(ctx, 0, sizeof(gdo_ctx_t));
+
+    /* dlfcn: an empty filename will actually return a handle to
+     * the main program, but we don't want that */
+    if (!filename || *filename == 0) {
+        memcpy(ctx->errbuf, _T("empty filename"), sizeof(_T("empty filename")));
+        return false;
+    }
+
+#ifdef GDO_WINAPI
+    (void)new_namespace;
+    ctx->handle = LoadLibraryEx(filename, NULL, flags);
+#else
+    ctx->handle = _gdo_call_dlopen(filename, flags, new_namespace);
+#endif
+
+    if (!ctx->handle) {
+        _GDO_CTX_SAVE_ERROR(ctx, _T("%s"), filename);
+        return false;
+    }
+
+    for (int i = 0; i < GDO_SYMBOL_COUNT; i++) {
+        const char *symbol = _gdo_symbol_name(i);
+        void *ptr = _gdo_call_dlsym(ctx->handle, symbol);
+
+        if (!ptr) {
+            _GDO_CTX_SAVE_ERROR(ctx, GDO_XHS, symbol);
+            _gdo_call_dlclose(ctx->handle);
+            memset(&ctx->api, 0, sizeof(gdo_api_t));
+            ctx->handle = NULL;
+            return false;
+        }
+
+        /* the context isn't shared yet, no atomic store needed */
+        memcpy((char *)&ctx->api + _gdo_ctx_offsets[i], &ptr, sizeof(void *));
+    }
+
+    return true;
+}
+
+
+/* free library of a context */
+GDO_LINKAGE bool gdo_ctx_free(gdo_ctx_t *ctx)
+{
+    ctx->errbuf[0] = 0;
+
+    if (ctx->handle && !_gdo_call_dlclose(ctx->handle)) {
+        _GDO_CTX_SAVE_ERROR(ctx, _T("%s"), _T("failed to free library"));
+        return false;
+    }
+
+    /* set pointers back to NULL */
+    memset(&ctx->api, 0, sizeof(gdo_api_t));
+    ctx->handle = NULL;
+
+    return true;
+}
+
+
+/* last error message of a context */
+GDO_LINKAGE const gdo_char_t *gdo_ctx_last_error(const gdo_ctx_t *ctx)
+{
+    return ctx->errbuf;
+}
+
+
+/* instance of a pool that the thread borrowed last */
+static GDO_THREAD_LOCAL int _gdo_pool_hint = 0;
+
+#ifdef _WIN32
+# define _GDO_POOL_LOCK(POOL)    AcquireSRWLockExclusive(&(POOL)->lock)
+# define _GDO_POOL_UNLOCK(POOL)  ReleaseSRWLockExclusive(&(POOL)->lock)
+# define _GDO_POOL_WAIT(POOL)    SleepConditionVariableSRW(&(POOL)->cond, &(POOL)->lock, INFINITE, 0)
+# define _GDO_POOL_SIGNAL(POOL)  WakeConditionVariable(&(POOL)->cond)
+#else
+# define _GDO_POOL_LOCK(POOL)    pthread_mutex_lock(&(POOL)->lock)
+# define _GDO_POOL_UNLOCK(POOL)  pthread_mutex_unlock(&(POOL)->lock)
+# define _GDO_POOL_WAIT(POOL)    pthread_cond_wait(&(POOL)->cond, &(POOL)->lock)
+# define _GDO_POOL_SIGNAL(POOL)  pthread_cond_signal(&(POOL)->cond)
+#endif
+
+
+/* load several instances of a library into a pool */
+GDO_LINKAGE bool gdo_pool_load(gdo_pool_t *pool, int size, const gdo_char_t *filename, int flags)
+{
+    memset(pool, 0, sizeof(gdo_pool_t));
+
+    if (size < 1) {
+        memcpy(pool->errbuf, _T("invalid pool size"), sizeof(_T("invalid pool size")));
+        return false;
+    }
+
+#ifdef GDO_HAVE_DLMOPEN
+    const bool new_namespace = true;
+#else
+    const bool new_namespace = false;
+
+    /* the same library would be loaded again */
+    if (size > 1) {
+        memcpy(pool->errbuf, _T("more than one instance requires dlmopen()"),
+            sizeof(_T("more than one instance requires dlmopen()")));
+        return false;
+    }
+#endif
+
+    pool->ctx = (gdo_ctx_t *)calloc((size_t)size, sizeof(gdo_ctx_t));
+    pool->busy = (long *)calloc((size_t)size, sizeof(long));
+
+    if (!pool->ctx || !pool->busy) {
+        free(pool->ctx);
+        free(pool->busy);
+        pool->ctx = NULL;
+        pool->busy = NULL;
+        memcpy(pool->errbuf, _T("failed to allocate memory"), sizeof(_T("failed to allocate memory")));
+        return false;
+    }
+
+    for (int i = 0; i < size; i++) {
+        if (!gdo_ctx_load(&pool->ctx[i], filename, flags, new_namespace)) {
+            memcpy(pool->errbuf, pool->ctx[i].errbuf, sizeof(pool->errbuf));
+
+            while (i-- > 0) {
+                gdo_ctx_free(&pool->ctx[i]);
+            }
+
+            free(pool->ctx);
+            free(pool->busy);
+            pool->ctx = NULL;
+            pool->busy = NULL;
+            return false;
+        }
+    }
+
+#ifdef _WIN32
+    InitializeSRWLock(&pool->lock);
+    InitializeConditionVariable(&pool->cond);
+#else
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->cond, NULL);
+#endif
+
+    pool->size = size;
+
+    return true;
+}
+
+
+/* borrow an instance without waiting */
+GDO_LINKAGE gdo_ctx_t *gdo_pool_try_acquire(gdo_pool_t *pool)
+{
+    if (pool->size < 1) {
+        return NULL;
+    }
+
+    /* start with the instance this thread used last, its pages
+     * are most likely still in the CPU caches */
+    const int start = _gdo_pool_hint % pool->size;
+
+    for (int n = 0; n < pool->size; n++) {
+        const int i = (start + n) % pool->size;
+
+        if (!GDO_ATOMIC_LOAD_LONG(&pool->busy[i]) && GDO_ATOMIC_TRYLOCK(&pool->busy[i])) {
+            _gdo_pool_hint = i;
+            return &pool->ctx[i];
+        }
+    }
+
+    return NULL;
+}
+
+
+/* borrow an instance, wait until one is available */
+GDO_LINKAGE gdo_ctx_t *gdo_pool_acquire(gdo_pool_t *pool)
+{
+    gdo_ctx_t *ctx;
+
+    if (pool->size < 1) {
+        return NULL;
+    }
+
+    /* fast path without the lock */
+    if ((ctx = gdo_pool_try_acquire(pool)) != NULL) {
+        return ctx;
+    }
+
+    /* Instances are only released while the lock is held, so one can't
+     * become available between the last try and the wait. */
+    _GDO_POOL_LOCK(pool);
+    pool->waiting++;
+
+    while ((ctx = gdo_pool_try_acquire(pool)) == NULL) {
+        _GDO_POOL_WAIT(pool);
+    }
+
+    pool->waiting--;
+    _GDO_POOL_UNLOCK(pool);
+
+    return ctx;
+}
+
+
+/* give back a borrowed instance */
+GDO_LINKAGE void gdo_pool_release(gdo_pool_t *pool, gdo_ctx_t *ctx)
+{
+    _GDO_POOL_LOCK(pool);
+    GDO_ATOMIC_UNLOCK(&pool->busy[ctx - pool->ctx]);
+
+    if (pool->waiting > 0) {
+        _GDO_POOL_SIGNAL(pool);
+    }
+
+    _GDO_POOL_UNLOCK(pool);
+}
+
+
+/* free all instances of a pool */
+GDO_LINKAGE bool gdo_pool_free(gdo_pool_t *pool)
+{
+    bool rv = true;
+
+    pool->errbuf[0] = 0;
+
+    for (int i = 0; i < pool->size; i++) {
+        if (!gdo_ctx_free(&pool->ctx[i])) {
+            memcpy(pool->errbuf, pool->ctx[i].errbuf, sizeof(pool->errbuf));
+            rv = false;
+        }
+    }
+
+#ifndef _WIN32
+    if (pool->size > 0) {
+        pthread_cond_destroy(&pool->cond);
+        pthread_mutex_destroy(&pool->lock);
+    }
+#endif
+
+    free(pool->ctx);
+    free(pool->busy);
+    pool->ctx = NULL;
+    pool->busy = NULL;
+    pool->size = 0;
+
+    return rv;
+}
+
+
+/* last error message of a pool */
+GDO_LINKAGE const gdo_char_t *gdo_pool_last_error(const gdo_pool_t *pool)
+{
+    return pool->errbuf;
+}
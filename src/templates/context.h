@@ -0,0 +1,207 @@
+/*****************************************************************************/
+/*                              C context API                                */
+/*****************************************************************************/
+
+#ifdef _WIN32
+# include <tchar.h>
+#else
+# include <pthread.h>
+# undef _T
+# define _T(x) x
+#endif
+
+/* declaration */
+#ifdef GDO_STATIC
+# define GDO_DECL  static inline
+#else
+# define GDO_DECL  extern
+#endif
+
+
+/**
+ * If compiling for win32 and `_UNICODE` is defined and `GDO_USE_DLOPEN` is NOT
+ * defined `gdo_char_t` will become `wchar_t`.
+ */
+#ifdef _GDO_TARGET_WIDECHAR
+typedef wchar_t gdo_char_t;
+#else
+typedef char    gdo_char_t;
+#endif
+
+
+/* length of the error message buffer of a context */
+#ifndef GDO_CTX_ERRLEN
+# define GDO_CTX_ERRLEN 512
+#endif
+
+
+/**
+ * Symbol pointer table of a library instance.
+ * Symbol names MUST be prefixed to avoid macro expansion.
+ */
+typedef struct _gdo_api
+{
+    %%type%% (*GDO_PTR_%%func_symbol%%)(%%args%%);
+    %%obj_type%% *GDO_PTR_%%obj_symbol%%;
+} gdo_api_t;
+
+
+/**
+ * Library instance context.
+ * Contexts don't share any data, so they can be used by different
+ * threads at the same time without any locking. The same library can
+ * be loaded into several contexts, i.e. with `dlmopen()' or from
+ * different paths.
+ */
+typedef struct _gdo_ctx
+{
+    gdo_api_t  api;                     /* symbol pointers */
+    gdo_hmod_t handle;                  /* library handle */
+    gdo_char_t errbuf[GDO_CTX_ERRLEN];  /* last error message */
+} gdo_ctx_t;
+
+
+/**
+ * Access a symbol through the pointer table of a context.
+ *
+ * ctx:
+ *   Pointer to a context.
+ *
+ * symbol:
+ *   Symbol name.
+ *
+ * Usage:
+ *   GDO_CTX(ctx, my_function)(a, b);
+ *   x = *GDO_CTX(ctx, my_object);
+ */
+#define GDO_CTX(ctx, symbol)  ((ctx)->api.GDO_PTR_##symbol)
+
+
+/**
+ * Load a library and all symbols into a context.
+ *
+ * ctx:
+ *   Context to initialize. Any previous content is overwritten.
+ *
+ * filename:
+ *   Library filename or path to load. Must not be empty or NULL.
+ *
+ * flags:
+ *   Flags to pass to `dlopen()' or `LoadLibraryEx()'.
+ *   Use GDO_DEFAULT_FLAGS for the default flags.
+ *
+ * new_namespace:
+ *   dlmopen() only: load the library into a new namespace, so each context
+ *   gets its own copy of the library's global data.
+ *
+ * On success true is returned. On error false is returned, no library is
+ * loaded and the error message can be retrieved with gdo_ctx_last_error().
+ */
+GDO_DECL bool gdo_ctx_load(gdo_ctx_t *ctx, const gdo_char_t *filename, int flags, bool new_namespace)
+    GDO_GCC_ATTRIBUTE (warn_unused_result);
+
+
+/**
+ * Free the library of a context and set all symbol pointers to NULL.
+ *
+ * ctx:
+ *   Context initialized with gdo_ctx_load().
+ *
+ * If the library couldn't be freed false is returned and the error message
+ * can be retrieved with gdo_ctx_last_error().
+ */
+GDO_DECL bool gdo_ctx_free(gdo_ctx_t *ctx);
+
+
+/**
+ * Return the last error message of a context or an empty string.
+ */
+GDO_DECL const gdo_char_t *gdo_ctx_last_error(const gdo_ctx_t *ctx);
+
+
+/**
+ * Pool of library instances, each loaded into its own namespace.
+ * Libraries with global state that aren't thread-safe can be used in
+ * parallel by borrowing one instance per thread or per task.
+ * Threads waiting for an instance are blocked on a condition variable, so
+ * the program must be linked against the threads library (i.e. `-pthread').
+ */
+typedef struct _gdo_pool
+{
+    gdo_ctx_t *ctx;                     /* library instances */
+    long *busy;                         /* whether an instance is borrowed */
+    int size;                           /* number of instances */
+    int waiting;                        /* threads waiting for an instance */
+#ifdef _WIN32
+    SRWLOCK lock;                       /* held while an instance is released */
+    CONDITION_VARIABLE cond;            /* signaled when an instance was released */
+#else
+    pthread_mutex_t lock;               /* held while an instance is released */
+    pthread_cond_t cond;                /* signaled when an instance was released */
+#endif
+    gdo_char_t errbuf[GDO_CTX_ERRLEN];  /* last error message */
+} gdo_pool_t;
+
+
+/**
+ * Load several instances of a library into a pool.
+ *
+ * pool:
+ *   Pool to initialize. Any previous content is overwritten.
+ *
+ * size:
+ *   Number of instances to load.
+ *
+ * filename, flags:
+ *   Same as on gdo_ctx_load().
+ *
+ * Each instance is loaded with `dlmopen()' into a new namespace, so it gets
+ * its own copy of the library's global data and of its dependencies
+ * (including the C library). Glibc supports at most 16 namespaces per
+ * process, including the main namespace, and usually runs out of static TLS
+ * space earlier, after about 10 namespaces.
+ * Without `dlmopen()' (i.e. on Windows) only a single instance can be loaded.
+ *
+ * On success true is returned. On error false is returned, no library is
+ * loaded and the error message can be retrieved with gdo_pool_last_error().
+ */
+GDO_DECL bool gdo_pool_load(gdo_pool_t *pool, int size, const gdo_char_t *filename, int flags)
+    GDO_GCC_ATTRIBUTE (warn_unused_result);
+
+
+/**
+ * Borrow an instance from a pool.
+ *
+ * gdo_pool_acquire() blocks until an instance is available.
+ * gdo_pool_try_acquire() returns NULL if all instances are borrowed.
+ * The instance that the calling thread borrowed last is preferred.
+ *
+ * Both functions can be called from any thread and return NULL if the
+ * pool wasn't loaded. The returned context must be given back with
+ * gdo_pool_release().
+ */
+GDO_DECL gdo_ctx_t *gdo_pool_acquire(gdo_pool_t *pool);
+GDO_DECL gdo_ctx_t *gdo_pool_try_acquire(gdo_pool_t *pool);
+
+
+/**
+ * Give back an instance borrowed with gdo_pool_acquire() or
+ * gdo_pool_try_acquire().
+ */
+GDO_DECL void gdo_pool_release(gdo_pool_t *pool, gdo_ctx_t *ctx);
+
+
+/**
+ * Free all instances of a pool. No instance may be borrowed anymore.
+ *
+ * If a library couldn't be freed false is returned and the error message
+ * can be retrieved with gdo_pool_last_error(). The other instances are
+ * freed anyway.
+ */
+GDO_DECL bool gdo_pool_free(gdo_pool_t *pool);
+
+
+/**
+ * Return the last error message of a pool or an empty string.
+ */
+GDO_DECL const gdo_char_t *gdo_pool_last_error(const gdo_pool_t *pool);
@@ -2,9 +2,14 @@
 # pragma comment(lib, "user32.lib")  /* dependency for MessageBox() */
 #endif
 
+#include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <algorithm>
+#ifdef GDO_ENABLE_ASYNC_LOADING
+# include <chrono>
+# include <thread>
+#endif
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
@@ -39,9 +44,73 @@ gdo::dl::msgcb_t gdo::dl::m_message_callback = gdo::dl::default_message_callback
 gdo_hmod_t gdo::dl::m_handle = nullptr;
 
 
-/* symbol pointers; symbol names must be prefixed to avoid macro expansion */
-%%type%% (*GDO_RAWPTR_%%func_symbol%%)(%%args%%) = nullptr;
-%%obj_type%% *GDO_RAWPTR_%%obj_symbol%% = nullptr;
+#ifdef GDO_HAVE_LOAD_MEMORY
+/* memory file of a library loaded from memory */
+int gdo::dl::m_memfd = -1;
+#endif
+
+
+/* error state */
+thread_local const char *gdo::dl::m_errmsg = nullptr;
+thread_local char gdo::dl::m_errbuf[GDO_BUFLEN];
+#ifdef GDO_WINAPI
+thread_local DWORD gdo::dl::m_last_errno = 0;
+thread_local const wchar_t *gdo::dl::m_werrmsg = nullptr;
+thread_local wchar_t gdo::dl::m_werrbuf[GDO_BUFLEN];
+#endif
+
+
+/* save a copy of a temporary message */
+void gdo::dl::save_to_errbuf(const char *msg)
+{
+    if (msg) {
+        std::snprintf(m_errbuf, sizeof(m_errbuf), "%s", msg);
+        m_errmsg = m_errbuf;
+    } else {
+        m_errmsg = nullptr;
+    }
+}
+
+
+/* symbol pointers */
+gdo::symbol_ptrs gdo::sym_ptr = {};
+
+
+/* offsets of the symbol pointers in order of the GDO_LOAD_* values;
+ * unlike a table of addresses this doesn't need any relocations */
+static const size_t gdo_ptr_offsets[GDO_ENUM_LAST] = {
+    offsetof(gdo::symbol_ptrs, GDO_PTR_%%symbol%%),
+};
+
+/* address of a symbol pointer */
+static inline void *gdo_ptr_slot(int symbol_num)
+{
+    return reinterpret_cast<char *>(&gdo::sym_ptr) + gdo_ptr_offsets[symbol_num];
+}
+
+
+/* loaded symbols */
+static _gdo_loaded_t gdo_loaded = {};
+
+
+#ifdef GDO_ENABLE_LOAD_STATS
+/* load diagnostics */
+static gdo_load_stats_t gdo_stats = {};
+#endif
+
+
+#ifdef GDO_HAVE_PREFETCH
+/* library that was prefetched with prefetch() */
+static long gdo_prefetched = 0;
+#endif
+
+
+#if defined(GDO_HAVE_LOAD_MEMORY) && defined(GDO_EMBEDDED_LIB_DATA)
+/* library image embedded with `-embed' */
+static const unsigned char gdo_embedded_lib[GDO_EMBEDDED_LIB_SIZE] = {
+    GDO_EMBEDDED_LIB_DATA
+};
+#endif
 
 
 /* Create versioned shared library names.
@@ -144,10 +213,8 @@ bool gdo::dl::convert_string(const std::basic_string<T_in> &str_in, std::basic_s
 void gdo::dl::clear_error()
 {
     m_last_errno = 0;
-    m_errmsg.clear();
-    m_werrmsg.clear();
-    m_formatted.clear();
-    m_wformatted.clear();
+    m_errmsg = nullptr;
+    m_werrmsg = nullptr;
 }
 
 
@@ -164,7 +231,7 @@ void gdo::dl::save_error(const std::string &msg)
 {
     clear_error();
     m_last_errno = ::GetLastError();
-    m_errmsg = msg;
+    save_to_errbuf(msg.c_str());
 }
 
 
@@ -173,7 +240,8 @@ void gdo::dl::save_error(const std::wstring &msg)
 {
     clear_error();
     m_last_errno = ::GetLastError();
-    m_werrmsg = msg;
+    ::wcsncpy_s(m_werrbuf, _countof(m_werrbuf), msg.c_str(), _TRUNCATE);
+    m_werrmsg = m_werrbuf;
 }
 
 
@@ -330,16 +398,14 @@ std::basic_string<T_out> gdo::dl::format_error_message(const std::basic_string<T
 /* clear error */
 void gdo::dl::clear_error()
 {
-    m_errmsg.clear();
-    ::dlerror();
+    m_errmsg = nullptr;
 }
 
 
 /* save last error */
 void gdo::dl::save_error(const std::string&)
 {
-    const char *ptr = ::dlerror();
-    m_errmsg = ptr ? ptr : "";
+    save_to_errbuf(::dlerror());
 }
 
 
@@ -355,7 +421,18 @@ void gdo::dl::set_error_invalid_handle()
 void gdo::dl::load_lib(const std::string &filename)
 {
     clear_error();
+
+#ifdef GDO_HAVE_PREFETCH
+    _gdo_prefetch_once(&gdo_prefetched, filename.c_str());
+#endif
+
     m_handle = _gdo_call_dlopen(filename.c_str(), m_flags, m_new_namespace);
+
+#ifdef GDO_HAVE_PREFETCH
+    if (m_handle) {
+        _gdo_prefetch_text(m_handle);
+    }
+#endif
 }
 
 
@@ -459,8 +536,8 @@ bool gdo::dl::get_library_path_dlinfo(void)
 # ifdef __linux__
     char buf[GDO_BUFLEN];
 
-    /* if the path is relative try to get the full library path from /proc/self/maps */
-    if (lm->l_name[0] != '/' && _gdo_fullpath_procmap(lm, buf, GDO_BUFLEN)) {
+    /* if the path is relative try to get the full library path */
+    if (lm->l_name[0] != '/' && _gdo_fullpath_linkmap(lm, buf, GDO_BUFLEN)) {
         m_libpath = buf;
         return true;
     }
@@ -503,7 +580,13 @@ bool gdo::dl::get_library_path_dladdr(void)
 template<typename T>
 T gdo::dl::sym_load(const char *symbol)
 {
+#ifdef GDO_ENABLE_LOAD_STATS
+    const uint64_t start = _gdo_time_ns();
+    T ptr = reinterpret_cast<T>(_gdo_call_dlsym(m_handle, symbol));
+    _gdo_stats_sym(&gdo_stats, start, (ptr != nullptr));
+#else
     T ptr = reinterpret_cast<T>(_gdo_call_dlsym(m_handle, symbol));
+#endif
 
     if (!ptr) {
         save_error();
@@ -531,8 +614,26 @@ bool gdo::dl::load_filename(const T &filename)
         return false;
     }
 
+#ifdef GDO_ENABLE_LOAD_STATS
+    const long objects = _gdo_object_count();
+    const uint64_t start = _gdo_time_ns();
+#endif
+
     load_lib(filename);
 
+#ifdef GDO_HAVE_HUGE_TEXT
+    /* nothing is done if the library wasn't loaded */
+    const uint64_t huge_text = _gdo_remap_huge_text(m_handle);
+    (void)huge_text;
+#endif
+
+#ifdef GDO_ENABLE_LOAD_STATS
+    _gdo_stats_load(&gdo_stats, start, objects);
+# ifdef GDO_HAVE_HUGE_TEXT
+    gdo_stats.huge_text = huge_text;
+# endif
+#endif
+
     if (!lib_loaded()) {
         save_error(filename);
         return false;
@@ -629,6 +730,65 @@ bool gdo::dl::load(const std::wstring &filename, int flags)
 #endif //GDO_WINAPI
 
 
+#ifdef GDO_HAVE_LOAD_MEMORY
+
+/* load library from memory */
+bool gdo::dl::load_memory(const void *data, size_t size, int flags, bool new_namespace)
+{
+    const char *errmsg = nullptr;
+
+    clear_error();
+
+    /* consider it an error if the library was already loaded */
+    if (lib_loaded()) {
+        m_errmsg = "library already loaded";
+        return false;
+    }
+
+    if (!data || size == 0) {
+        m_errmsg = "empty library image";
+        return false;
+    }
+
+    m_filename.clear();
+    m_flags         = flags;
+    m_new_namespace = new_namespace;
+
+#ifdef GDO_ENABLE_LOAD_STATS
+    const long objects = _gdo_object_count();
+    const uint64_t start = _gdo_time_ns();
+#endif
+
+    m_handle = _gdo_dlopen_memory(data, size, m_flags, m_new_namespace, &m_memfd, &errmsg);
+
+#ifdef GDO_ENABLE_LOAD_STATS
+    _gdo_stats_load(&gdo_stats, start, objects);
+#endif
+
+    if (!lib_loaded()) {
+        if (errmsg) {
+            m_errmsg = errmsg;
+        } else {
+            save_error();
+        }
+        return false;
+    }
+
+    return true;
+}
+
+
+# ifdef GDO_EMBEDDED_LIB_DATA
+/* load the embedded library */
+bool gdo::dl::load_embedded(int flags, bool new_namespace)
+{
+    return load_memory(gdo_embedded_lib, sizeof(gdo_embedded_lib), flags, new_namespace);
+}
+# endif
+
+#endif //GDO_HAVE_LOAD_MEMORY
+
+
 /* load library */
 bool gdo::dl::load()
 {
@@ -675,14 +835,36 @@ bool gdo::dl::load_all_symbols()
         return false;
     }
 
+#ifdef GDO_HAVE_SYMBOL_CACHE
+    /* take symbol offsets from the cache file */
+    if (_gdo_symbol_cache_load(m_handle, gdo_ptr_slot, &gdo_loaded)) {
+        return true;
+    }
+#endif
+
+#ifdef GDO_HAVE_ELF_RESOLVER
+    /* resolve most symbols at once */
+    _gdo_elf_resolve_all(m_handle, gdo_ptr_slot, &gdo_loaded);
+#endif
+
     /* get symbol addresses */
+    for (int i = 0; i < GDO_ENUM_LAST; i++) {
+        if (_gdo_get_ptr(gdo_ptr_slot(i)) != nullptr) {
+            continue;
+        }
 
-    /* %%symbol%% */@
-    if ((GDO_RAWPTR_%%symbol%% =@
-        sym_load<%%sym_type%%>@
-            ("%%symbol%%")) == nullptr) {@
-        return false;@
-    }@
+        void *ptr = sym_load<void *>(_gdo_symbol_name(i));
+
+        if (!ptr) {
+            return false;
+        }
+
+        _gdo_store_symbol(&gdo_loaded, gdo_ptr_slot(i), i, ptr);
+    }
+
+#ifdef GDO_HAVE_SYMBOL_CACHE
+    _gdo_symbol_cache_save(m_handle, gdo_ptr_slot);
+#endif
 
     return true;
 }
@@ -698,23 +880,19 @@ bool gdo::dl::load_symbol(int symbol_num)
         return false;
     }
 
-    switch (symbol_num)
-    {
-    /* %%symbol%% */@
-    case GDO_LOAD_%%symbol%%:@
-        if (!GDO_RAWPTR_%%symbol%%) {@
-            GDO_RAWPTR_%%symbol%% =@
-                sym_load<%%sym_type%%>@
-                    ("%%symbol%%");@
-        }@
-        return (GDO_RAWPTR_%%symbol%% != nullptr);@
-
-    default:
-        break;
+    if (symbol_num >= 0 && symbol_num < GDO_ENUM_LAST) {
+        void *slot = gdo_ptr_slot(symbol_num);
+
+        if (!_gdo_get_ptr(slot)) {
+            _gdo_store_symbol(&gdo_loaded, slot, symbol_num, sym_load<void *>(_gdo_symbol_name(symbol_num)));
+        }
+
+        return (_gdo_get_ptr(slot) != nullptr);
     }
 
     GDO_SET_LAST_ERRNO(ERROR_NOT_FOUND);
-    m_errmsg = "unknown symbol number: " + std::to_string(symbol_num);
+    std::snprintf(m_errbuf, sizeof(m_errbuf), "unknown symbol number: %d", symbol_num);
+    m_errmsg = m_errbuf;
 
     return false;
 }
@@ -736,71 +914,226 @@ bool gdo::dl::load_symbol(const char *symbol)
         return false;
     }
 
-    /* check symbol prefix */
-    const char pfx[] = GDO_COMMON_PREFIX;
-    const size_t pfxlen = sizeof(pfx) - 1;
-
-    if (pfxlen == 0 || ::strncmp(symbol, pfx, pfxlen) == 0) {
-        const size_t len = ::strlen(symbol);
-        const char *curr;
-        size_t curr_len;
-@
-        curr = "%%symbol%%";@
-        curr_len = sizeof("%%symbol%%") - 1;@
-        if (len == curr_len && ::strcmp(symbol + pfxlen, curr + pfxlen) == 0) {@
-            if (!GDO_RAWPTR_%%symbol%%) {@
-                GDO_RAWPTR_%%symbol%% =@
-                    sym_load<%%sym_type%%>@
-                        ("%%symbol%%");@
-            }@
-            return (GDO_RAWPTR_%%symbol%% != nullptr);@
-        }
+    /* perfect hash lookup */
+    const int symbol_num = _gdo_symbol_index(symbol);
+
+    if (symbol_num != -1) {
+        return load_symbol(symbol_num);
     }
 
     GDO_SET_LAST_ERRNO(ERROR_NOT_FOUND);
-    m_errmsg = "unknown symbol: " + std::string(symbol);
+    std::snprintf(m_errbuf, sizeof(m_errbuf), "unknown symbol: %s", symbol);
+    m_errmsg = m_errbuf;
 
     return false;
 }
 
 
-/* check if ALL symbols were loaded */
-bool gdo::dl::all_symbols_loaded() const
+#ifdef GDO_ENABLE_ASYNC_LOADING
+
+/* asynchronous load */
+std::mutex gdo::dl::m_async_mutex;
+std::shared_future<bool> gdo::dl::m_async;
+bool gdo::dl::m_async_has_msg = false;
+char gdo::dl::m_async_errbuf[GDO_BUFLEN];
+#ifdef GDO_WINAPI
+DWORD gdo::dl::m_async_last_errno = 0;
+#endif
+
+
+/* load library on a background thread */
+std::future<bool> gdo::dl::load_async(const std::string &filename, int flags, bool new_namespace, bool load_symbols)
 {
-    if (true
-        && GDO_RAWPTR_%%symbol%% != nullptr
-    ) {
-        return true;
+    std::promise<bool> result, shared;
+    std::future<bool> fut = result.get_future();
+    std::lock_guard<std::mutex> lock(m_async_mutex);
+
+    clear_error();
+
+    if (m_async.valid() && m_async.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        m_errmsg = "asynchronous load already pending";
+        result.set_value(false);
+        return fut;
     }
 
-    return false;
+    if (lib_loaded()) {
+        m_errmsg = "library already loaded";
+        result.set_value(false);
+        return fut;
+    }
+
+    /* the caller gets its own future, wrapper functions use the shared one */
+    m_async = shared.get_future().share();
+
+    auto task = [this, filename, flags, new_namespace, load_symbols] (std::promise<bool> p_result, std::promise<bool> p_shared)
+    {
+        bool rv = load(filename, flags, new_namespace) && (!load_symbols || load_all_symbols());
+
+        {
+            /* the error state is thread-local, save a copy for the waiting threads */
+            std::lock_guard<std::mutex> lock(m_async_mutex);
+
+            m_async_has_msg = (!rv && m_errmsg);
+
+            if (m_async_has_msg) {
+                std::snprintf(m_async_errbuf, sizeof(m_async_errbuf), "%s", m_errmsg);
+            }
+#ifdef GDO_WINAPI
+            m_async_last_errno = m_last_errno;
+#endif
+        }
+
+        p_shared.set_value(rv);
+        p_result.set_value(rv);
+    };
+
+    std::thread(task, std::move(result), std::move(shared)).detach();
+
+    return fut;
 }
 
 
-/* check if NO symbols were loaded */
-bool gdo::dl::no_symbols_loaded() const
+/* wait for the asynchronous load */
+bool gdo::dl::wait_loaded(long timeout_ms)
 {
-    if (true
-        && GDO_RAWPTR_%%symbol%% == nullptr
-    ) {
+    std::shared_future<bool> async;
+
+    {
+        std::lock_guard<std::mutex> lock(m_async_mutex);
+        async = m_async;
+    }
+
+    clear_error();
+
+    if (!async.valid()) {
+        m_errmsg = "no asynchronous load was started";
+        return false;
+    }
+
+    if (timeout_ms < 0) {
+        async.wait();
+    } else if (async.wait_for(std::chrono::milliseconds(timeout_ms)) != std::future_status::ready) {
+        GDO_SET_LAST_ERRNO(ERROR_TIMEOUT);
+        m_errmsg = "timed out waiting for the library to load";
+        return false;
+    }
+
+    if (async.get()) {
         return true;
     }
 
+    std::lock_guard<std::mutex> lock(m_async_mutex);
+    save_to_errbuf(m_async_has_msg ? m_async_errbuf : nullptr);
+    GDO_SET_LAST_ERRNO(m_async_last_errno);
+
     return false;
 }
 
+#endif // GDO_ENABLE_ASYNC_LOADING
+
+
+/* check if ALL symbols were loaded */
+bool gdo::dl::all_symbols_loaded() const
+{
+    return (_gdo_loaded_count(&gdo_loaded) == GDO_ENUM_LAST);
+}
+
+
+/* check if NO symbols were loaded */
+bool gdo::dl::no_symbols_loaded() const
+{
+    return (_gdo_loaded_count(&gdo_loaded) == 0);
+}
+
 
 /* check if ANY symbol was loaded */
 bool gdo::dl::any_symbol_loaded() const
 {
-    if (false
-        || GDO_RAWPTR_%%symbol%% != nullptr
-    ) {
+    return (_gdo_loaded_count(&gdo_loaded) != 0);
+}
+
+
+#ifdef GDO_GROUP_COUNT
+/* load all symbols of a group */
+bool gdo::dl::load_group(int group)
+{
+    const uint32_t *words, *bits;
+
+    clear_error();
+
+    if (group < 0 || group >= GDO_GROUP_COUNT) {
+        GDO_SET_LAST_ERRNO(ERROR_NOT_FOUND);
+        std::snprintf(m_errbuf, sizeof(m_errbuf), "unknown symbol group: %d", group);
+        m_errmsg = m_errbuf;
+        return false;
+    }
+
+    if (_gdo_group_loaded(&gdo_loaded, group)) {
         return true;
+    } else if (!lib_loaded()) {
+        set_error_invalid_handle();
+        return false;
     }
 
-    return false;
+    const size_t n = _gdo_group_masks(group, &words, &bits);
+
+    /* get symbol addresses */
+    for (size_t i = 0; i < n; i++) {
+        for (int j = 0; j < 32; j++) {
+            const int symbol_num = static_cast<int>(words[i]) * 32 + j;
+
+            if ((bits[i] & (static_cast<uint32_t>(1) << j)) == 0 ||
+                _gdo_get_ptr(gdo_ptr_slot(symbol_num)) != nullptr)
+            {
+                continue;
+            }
+
+            void *ptr = sym_load<void *>(_gdo_symbol_name(symbol_num));
+
+            if (!ptr) {
+                return false;
+            }
+
+            _gdo_store_symbol(&gdo_loaded, gdo_ptr_slot(symbol_num), symbol_num, ptr);
+        }
+    }
+
+    return true;
+}
+
+
+/* check if all symbols of a group were loaded */
+bool gdo::dl::group_loaded(int group) const
+{
+    return (group >= 0 && group < GDO_GROUP_COUNT && _gdo_group_loaded(&gdo_loaded, group));
+}
+#endif //GDO_GROUP_COUNT
+
+
+#ifdef GDO_HAVE_PREFETCH
+/* read a library into the page cache */
+bool gdo::dl::prefetch(const std::string &filename)
+{
+    if (filename.empty() || !_gdo_prefetch(filename.c_str())) {
+        return false;
+    }
+
+    _gdo_prefetch_mark(&gdo_prefetched, filename.c_str());
+
+    return true;
 }
+#endif
+
+
+#ifdef GDO_ENABLE_LOAD_STATS
+/* retrieve load diagnostics */
+gdo_load_stats_t gdo::dl::load_stats()
+{
+    gdo_load_stats_t stats;
+    _gdo_stats_copy(&stats, &gdo_stats);
+    return stats;
+}
+#endif
 
 
 /* free library */
@@ -828,6 +1161,10 @@ bool gdo::dl::free(bool force)
         return false;
     }
 
+#ifdef GDO_HAVE_LOAD_MEMORY
+    _gdo_close_memfd(&m_memfd);
+#endif
+
     m_libpath.clear();
 #ifdef GDO_WINAPI
     m_wlibpath.clear();
@@ -835,7 +1172,8 @@ bool gdo::dl::free(bool force)
 
     /* set pointers back to NULL */
     m_handle = nullptr;
-    GDO_RAWPTR_%%symbol%% = nullptr;
+    std::memset(&gdo::sym_ptr, 0, sizeof(gdo::sym_ptr));
+    std::memset(&gdo_loaded, 0, sizeof(gdo_loaded));
 
     return true;
 }
@@ -894,20 +1232,12 @@ std::wstring gdo::dl::library_path_w()
 /* retrieve the last error */
 std::string gdo::dl::error()
 {
-    if (m_formatted.empty()) {
-        m_formatted = format_error_message<wchar_t, char>(m_werrmsg, m_errmsg);
-    }
-
-    return m_formatted;
+    return format_error_message<wchar_t, char>(m_werrmsg ? m_werrmsg : L"", m_errmsg ? m_errmsg : "");
 }
 
 std::wstring gdo::dl::error_w()
 {
-    if (m_wformatted.empty()) {
-        m_wformatted = format_error_message<char, wchar_t>(m_errmsg, m_werrmsg);
-    }
-
-    return m_wformatted;
+    return format_error_message<char, wchar_t>(m_errmsg ? m_errmsg : "", m_werrmsg ? m_werrmsg : L"");
 }
 
 
@@ -985,7 +1315,7 @@ std::string gdo::dl::library_path()
 /* retrieve the last error */
 std::string gdo::dl::error() const
 {
-    return m_errmsg.empty() ? "no error" : m_errmsg;
+    return m_errmsg ? m_errmsg : "no error";
 }
 
 
@@ -1006,11 +1336,57 @@ namespace gdo
     {
 #ifdef GDO_ENABLE_AUTOLOAD
         auto _loader = dl(GDO_DEFAULT_LIB);
+
+        /* only one thread at a time may auto-load the library and symbols */
+        long _autoload_lock = 0;
+#endif
+
+#ifdef GDO_ENABLE_AUTOLOAD_LAZY
+        /* symbols loaded right after the library was auto-loaded */
+        const int _critical_symbols[] = { GDO_CRITICAL_SYMBOLS };
+#endif
+
+#ifdef GDO_RECORD_PROFILE
+        _gdo_profile_t _profile;
+
+        void _profile_atexit()
+        {
+            _gdo_profile_save(&_profile, GDO_RECORD_PROFILE);
+        }
+
+        /* used by wrapper functions to count their calls */
+        void record_call(int load)
+        {
+            /* save the profile upon exit, ignore errors */
+            if (_gdo_profile_record(&_profile, load)) {
+                std::atexit(_profile_atexit);
+            }
+        }
 #endif
 
         /* used by wrapper functions (assuming symbol was not loaded) */
-        void not_loaded(int load, const char *sym)
+        void not_loaded(int load)
         {
+#ifdef GDO_ENABLE_ASYNC_LOADING
+            /* block on a pending asynchronous load instead of loading again */
+            dl::wait_loaded(-1);
+
+            if (_gdo_get_ptr(gdo_ptr_slot(load)) != nullptr) {
+                return;
+            }
+#endif
+
+#ifdef GDO_ENABLE_AUTOLOAD
+            _gdo_spin_lock(&_autoload_lock);
+
+            /* symbol was loaded by another thread in the meantime */
+            if (_gdo_get_ptr(gdo_ptr_slot(load)) != nullptr) {
+                _gdo_spin_unlock(&_autoload_lock);
+                return;
+            }
+#endif
+
+            const char *sym = _gdo_symbol_name(load);
             std::stringstream sstr;
 
             auto msg_callback = dl::message_callback();
@@ -1020,22 +1396,33 @@ namespace gdo
             /* load library */
             if (!_loader.lib_loaded()) {
                 _loader.load();
+
+# ifdef GDO_ENABLE_AUTOLOAD_LAZY
+                /* load the critical symbols eagerly, errors are reported
+                 * once their wrapper functions are called */
+                for (const int i : _critical_symbols) {
+                    if (i >= 0 && _loader.lib_loaded()) {
+                        _loader.load_symbol(i);
+                    }
+                }
+# endif
             }
 
 # ifdef GDO_ENABLE_AUTOLOAD_LAZY
             /* load a specific symbol */
             if (_loader.load_symbol(load)) {
+                _gdo_spin_unlock(&_autoload_lock);
                 return;
             }
 # else
             /* load all symbols */
             if (_loader.load_all_symbols()) {
+                _gdo_spin_unlock(&_autoload_lock);
                 return;
             }
-
-            UNUSED_REF(load);
 # endif
 
+            /* keep the lock, we're exiting */
             std::string msg = _loader.error();
 
             if (msg.find(GDO_DEFAULT_LIBA) != std::string::npos) {
@@ -1058,7 +1445,6 @@ namespace gdo
                 sstr << "fatal error: " << sym << ": symbol not loaded";
             }
 
-            UNUSED_REF(load);
             msg_callback(sstr.str().c_str());
             std::abort();
 
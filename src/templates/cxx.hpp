@@ -1,5 +1,9 @@
 #include <iostream>
 #include <string>
+#ifdef GDO_ENABLE_ASYNC_LOADING
+# include <future>
+# include <mutex>
+#endif
 #ifdef _AIX
 # include <inttypes.h>
 # include <sys/ldr.h>
@@ -19,11 +23,16 @@ namespace gdo
 {
 
 /**
- * Symbol pointers.
+ * Symbol pointers, aligned to a cache line.
  * Symbol names must be prefixed to avoid macro expansion.
  */
-extern %%type%% (*GDO_PTR_%%func_symbol%%)(%%args%%);
-extern %%obj_type%% *GDO_PTR_%%obj_symbol%%;
+struct GDO_CACHELINE_ALIGNED symbol_ptrs
+{
+    %%type%% (*GDO_PTR_%%func_symbol%%)(%%args%%);
+    %%obj_type%% *GDO_PTR_%%obj_symbol%%;
+};
+
+extern symbol_ptrs sym_ptr;
 
 
 /**
@@ -99,6 +108,11 @@ private:
     bool m_new_namespace = false;
     bool m_free_lib_in_dtor = true;
 
+#ifdef GDO_HAVE_LOAD_MEMORY
+    /* memory file of a library loaded from memory */
+    static int m_memfd;
+#endif
+
     /* std::enable_if and std::is_same combined */
     template<typename T, typename U>
     using enable_if_same_bool = typename std::enable_if<std::is_same<T, U>::value, bool>::type;
@@ -136,11 +150,32 @@ private:
         return wch;
     }
 
+    /**
+     * Error state of the calling thread: a static message or a copy of a
+     * temporary message saved in `m_errbuf'. The message is only formatted
+     * when error() is called.
+     */
+    static thread_local const char *m_errmsg;
+    static thread_local char m_errbuf[GDO_BUFLEN];
+
+    static void save_to_errbuf(const char *msg);
+
+#ifdef GDO_ENABLE_ASYNC_LOADING
+    /* asynchronous load and a copy of its error state */
+    static std::mutex m_async_mutex;
+    static std::shared_future<bool> m_async;
+    static bool m_async_has_msg;
+    static char m_async_errbuf[GDO_BUFLEN];
+# ifdef GDO_WINAPI
+    static DWORD m_async_last_errno;
+# endif
+#endif
+
 #ifdef GDO_WINAPI
 
-    DWORD m_last_errno = 0;
-    std::string m_errmsg, m_formatted;
-    std::wstring m_werrmsg, m_wformatted;
+    static thread_local DWORD m_last_errno;
+    static thread_local const wchar_t *m_werrmsg;
+    static thread_local wchar_t m_werrbuf[GDO_BUFLEN];
 
     bool mbs_wcs_conv(size_t *retval, wchar_t *out, size_t size, const char *in);
     bool mbs_wcs_conv(size_t *retval, char *out, size_t size, const wchar_t *in);
@@ -148,7 +183,7 @@ private:
     template<typename T_in, typename T_out>
     bool convert_string(const std::basic_string<T_in> &str_in, std::basic_string<T_out> &str_out);
 
-    void clear_error();
+    static void clear_error();
 
     void save_error();
     void save_error(const std::string &msg);
@@ -178,9 +213,7 @@ private:
 
 #else // !GDO_WINAPI
 
-    std::string m_errmsg;
-
-    void clear_error();
+    static void clear_error();
     void save_error(const std::string &msg = {}); /* `msg' is always ignored */
     void set_error_invalid_handle();
 
@@ -292,6 +325,69 @@ public:
     bool load_lib_and_symbols();
 
 
+#ifdef GDO_HAVE_LOAD_MEMORY
+    /**
+     * Load a library from memory (Linux only, enabled with GDO_ENABLE_LOAD_MEMORY
+     * or `-embed'). The image is copied into an anonymous memory file which is
+     * loaded from its path in `/proc/self/fd', so no library search paths are
+     * looked up.
+     *
+     * data, size:
+     *   Image of a shared library. If GDO_USE_ZLIB is defined the image may also
+     *   be zlib or gzip compressed. It can be freed after the call.
+     *
+     * flags, new_namespace:
+     *   Same as on `load()'.
+     *
+     * load_embedded() loads the library image that was embedded into the
+     * generated code with the `-embed' option.
+     *
+     * On success `true' is returned.
+     * On an error or if the library is already loaded the return value is `false'.
+     */
+    bool load_memory(const void *data, size_t size, int flags=default_flags, bool new_namespace=false);
+# ifdef GDO_EMBEDDED_LIB_DATA
+    bool load_embedded(int flags=default_flags, bool new_namespace=false);
+# endif
+#endif
+
+
+#ifdef GDO_ENABLE_ASYNC_LOADING
+    /**
+     * Load a library on a background thread, i.e. to run its constructors and
+     * relocations while the application continues with other initialization.
+     * The object must not be destroyed before the load has finished.
+     *
+     * filename, flags, new_namespace:
+     *   Same as on `load()'.
+     *
+     * load_symbols:
+     *   If true all symbols are loaded too.
+     *
+     * Returns a future with the result of the load. The result is `false' right
+     * away if another load is still pending or if the library is already loaded.
+     * Wrapper functions called in the meantime wait for the pending load.
+     * Objects must not be accessed before the load has finished.
+     */
+    std::future<bool> load_async(const std::string &filename, int flags=default_flags,
+                                 bool new_namespace=false, bool load_symbols=true);
+
+
+    /**
+     * Wait for the load started with `load_async()' to finish.
+     *
+     * timeout_ms:
+     *   Maximum time to wait in milliseconds. Wait without a time limit
+     *   if the value is negative.
+     *
+     * Returns the result of the load. On a timeout `false' is returned
+     * while the load continues in the background.
+     * Errors from the background thread are saved for the calling thread.
+     */
+    static bool wait_loaded(long timeout_ms=-1);
+#endif // GDO_ENABLE_ASYNC_LOADING
+
+
     /**
      * Returns `true' if the library was successfully loaded.
      */
@@ -329,6 +425,21 @@ public:
     bool any_symbol_loaded() const;
 
 
+#ifdef GDO_GROUP_COUNT
+    /**
+     * Load or check a symbol group declared with `%option group=<name>:<prefix>'.
+     *
+     * group:
+     *   Auto-generated value `GDO_GROUP_<name>'.
+     *
+     * load_group() returns `true' on success or if all symbols of the group
+     * were already loaded. Symbols outside of the group are not loaded.
+     */
+    bool load_group(int group);
+    bool group_loaded(int group) const;
+#endif
+
+
     /**
      * Free/release the library. Internal handle and pointers are set back to NULL
      * if the underlying calls were successful, in which case `true' is returned.
@@ -404,7 +515,7 @@ public:
 
 
     /**
-     * Return a string with the last saved error message.
+     * Return a string with the last saved error message of the calling thread.
      * The message will indicate if no error had occured.
      * This function doesn't return an empty string.
      */
@@ -415,6 +526,28 @@ public:
     std::string error() const;
 #endif
 
+
+#ifdef GDO_HAVE_PREFETCH
+    /**
+     * Advise the kernel to read a library and its direct dependencies that
+     * aren't loaded yet into the page cache, so a later load doesn't wait for
+     * the disk. Nothing is loaded. Can be called from any thread. The next
+     * load of the same filename skips its own prefetch.
+     * Returns false if the library file wasn't found.
+     */
+    static bool prefetch(const std::string &filename);
+#endif
+
+
+#ifdef GDO_ENABLE_LOAD_STATS
+    /**
+     * Return the load diagnostics.
+     * Symbol lookup statistics are summed up over all loads, the load time and
+     * number of new shared objects are taken from the last call to load a library.
+     */
+    static gdo_load_stats_t load_stats();
+#endif
+
 };
 /******************************* end of class ********************************/
 
@@ -424,8 +557,8 @@ public:
 /**
  * Prefixed aliases, useful if GDO_DISABLE_ALIASING was defined.
  */
-#define GDO_RAWPTR_%%func_symbol_pad%% gdo::GDO_PTR_%%func_symbol%%
-#define GDO_RAWPTR_%%obj_symbol_pad%% gdo::GDO_PTR_%%obj_symbol%%
+#define GDO_RAWPTR_%%func_symbol_pad%% gdo::sym_ptr.GDO_PTR_%%func_symbol%%
+#define GDO_RAWPTR_%%obj_symbol_pad%% gdo::sym_ptr.GDO_PTR_%%obj_symbol%%
 %PARAM_SKIP_REMOVE_BEGIN%
 
 
@@ -452,26 +585,37 @@ GDO_WARNING("GDO_WRAP_VISIBILITY defined but wrapper function %%func_symbol%%()
 
 namespace gdo {
     namespace wrap {
-        void not_loaded(int load, const char *sym);
+        void not_loaded(int load);
+#ifdef GDO_RECORD_PROFILE
+        void record_call(int load);
+#endif
     }
 }
 
+#ifdef GDO_RECORD_PROFILE
+# define _GDO_RECORD_CALL(LOAD)  gdo::wrap::record_call(LOAD)
+#else
+# define _GDO_RECORD_CALL(LOAD)  (void)0
+#endif
+
 @
 /* %%func_symbol%%() */@
 #ifdef GDO_HAS_VA_ARGS_%%func_symbol%%@
     template<typename... Types>@
     %%type%% GDO_WRAP(%%func_symbol%%) (Types... args) {@
-        if (!GDO_RAWPTR_%%func_symbol%%) {@
-            gdo::wrap::not_loaded(GDO_LOAD_%%func_symbol%%, "%%func_symbol%%");@
+        _GDO_RECORD_CALL(GDO_LOAD_%%func_symbol%%);@
+        if (GDO_UNLIKELY(!GDO_ATOMIC_LOAD_PTR(&GDO_RAWPTR_%%func_symbol%%))) {@
+            gdo::wrap::not_loaded(GDO_LOAD_%%func_symbol%%);@
         }@
         GDO_HOOK_%%func_symbol%%(args...);@
         %%return%% GDO_RAWPTR_%%func_symbol%%(args...);@
     }@
 #else@
-    GDO_WRAP_DECL@
+    GDO_WRAP_DECL GDO_WRAP_ATTR(%%func_symbol%%)@
     %%type%% GDO_WRAP(%%func_symbol%%) (%%args%%) {@
-        if (!GDO_RAWPTR_%%func_symbol%%) {@
-            gdo::wrap::not_loaded(GDO_LOAD_%%func_symbol%%, "%%func_symbol%%");@
+        _GDO_RECORD_CALL(GDO_LOAD_%%func_symbol%%);@
+        if (GDO_UNLIKELY(!GDO_ATOMIC_LOAD_PTR(&GDO_RAWPTR_%%func_symbol%%))) {@
+            gdo::wrap::not_loaded(GDO_LOAD_%%func_symbol%%);@
         }@
         GDO_HOOK_%%func_symbol%%(%%param_names%%);@
         %%return%% GDO_RAWPTR_%%func_symbol%%(%%param_names%%);@
@@ -77,6 +77,7 @@ namespace output
         c,
         cxx,
         plugin,
+        context,
         minimal,
         minimal_cxx
     } format;
@@ -166,6 +166,46 @@ size_t utils::count_linefeed(const std::string &str)
     return n;
 }
 
+/* ELF GNU hash (DT_GNU_HASH) */
+uint32_t utils::gnu_hash(const std::string &str)
+{
+    uint32_t h = 5381;
+
+    for (const char &c : str) {
+        h = (h << 5) + h + static_cast<uint8_t>(c);
+    }
+
+    return h;
+}
+
+/* ELF SysV hash (DT_HASH) */
+uint32_t utils::sysv_hash(const std::string &str)
+{
+    uint32_t h = 0;
+
+    for (const char &c : str) {
+        h = (h << 4) + static_cast<uint8_t>(c);
+
+        uint32_t g = h & 0xf0000000;
+
+        if (g != 0) {
+            h ^= g >> 24;
+        }
+
+        h &= ~g;
+    }
+
+    return h;
+}
+
+/* format as unsigned hexadecimal C literal */
+std::string utils::hex_literal(uint32_t val)
+{
+    char buf[16];
+    snprintf(buf, sizeof(buf), "0x%08xu", static_cast<unsigned int>(val));
+    return buf;
+}
+
 /* read input lines */
 bool utils::get_lines(FILE *fp, template_t &entry)
 {
@@ -28,6 +28,7 @@
 # include <strings.h>
 #endif
 #include <errno.h>  /* program_invocation_short_name */
+#include <stdint.h>
 #include <stdio.h>
 #include <string.h>
 #include <algorithm>
@@ -108,6 +109,15 @@ void replace(const std::string &from, const std::string &to, std::string &s);
 size_t count_linefeed(const std::string &str);
 
 
+/* ELF hash functions (DT_GNU_HASH and DT_HASH) */
+uint32_t gnu_hash(const std::string &str);
+uint32_t sysv_hash(const std::string &str);
+
+
+/* format as unsigned hexadecimal C literal, i.e. "0x0000ffffu" */
+std::string hex_literal(uint32_t val);
+
+
 /* read input lines */
 bool get_lines(FILE *fp, template_t &entry);
 
@@ -0,0 +1,70 @@
+#include <stdio.h>
+#include <string.h>
+#include "helloworld.h"
+
+/* load the library on a background thread */
+#define GDO_ENABLE_ASYNC_LOADING 1
+
+/* use wrap functions that will wait for a pending load */
+#define GDO_WRAP_FUNCTIONS 1
+
+/* include generated header file */
+#include "c_async.h"
+
+
+void cb(const char *msg)
+{
+    puts(msg);
+}
+
+int main()
+{
+    /* nothing to wait for */
+    if (gdo_wait_loaded(0)) {
+        fprintf(stderr, "gdo_wait_loaded() succeeded without a pending load\n");
+        return 1;
+    }
+
+    /* errors from the background thread are passed to the waiting thread */
+    if (!gdo_load_lib_async(GDO_LIBNAME(nonexistent,0), GDO_DEFAULT_FLAGS, false, true)) {
+        fprintf(stderr, "%s\n", gdo_last_error());
+        return 1;
+    }
+
+    if (gdo_wait_loaded(-1) || !strstr(gdo_last_error(), "nonexistent")) {
+        fprintf(stderr, "loading a nonexistent library didn't fail\n");
+        return 1;
+    }
+
+    printf("expected error: %s\n", gdo_last_error());
+
+    /* load library and symbols */
+    if (!gdo_load_lib_async(GDO_LIBNAME(helloworld,0), GDO_DEFAULT_FLAGS, false, true)) {
+        fprintf(stderr, "%s\n", gdo_last_error());
+        return 1;
+    }
+
+    /* wrapper functions wait for the pending load */
+    helloworld *hw = helloworld_init();
+
+    if (!gdo_wait_loaded(1000)) {
+        fprintf(stderr, "%s\n", gdo_last_error());
+        return 1;
+    }
+
+    /* objects may only be used after waiting */
+    helloworld_callback = cb;
+    helloworld_hello(hw);
+    helloworld_release(hw);
+
+    /* library is already loaded */
+    if (gdo_load_lib_async(GDO_LIBNAME(helloworld,0), GDO_DEFAULT_FLAGS, false, true)) {
+        fprintf(stderr, "library was loaded twice\n");
+        return 1;
+    }
+
+    /* free resources */
+    gdo_free_lib();
+
+    return 0;
+}
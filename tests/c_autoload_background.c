@@ -0,0 +1,61 @@
+#include <stdio.h>
+#include <time.h>
+#include "helloworld.h"
+
+/* load symbols that weren't needed yet on a background thread */
+#define GDO_ENABLE_AUTOLOAD_BACKGROUND 1
+
+/* loaded before the background thread is started */
+#define GDO_CRITICAL_SYMBOLS GDO_LOAD_helloworld_init, GDO_LOAD_helloworld_release
+
+/* define a default library to load; this is required */
+#define GDO_DEFAULT_LIB GDO_LIBNAME(helloworld,0)
+
+/* include generated header file */
+#include "c_autoload_background.h"
+
+
+void cb(const char *msg)
+{
+    puts(msg);
+}
+
+int main()
+{
+    for (int i = 0; i < 3; i++) {
+        helloworld *hw = helloworld_init();
+
+        /* critical symbols were loaded together with the first symbol */
+        if (!GDO_RAWPTR_helloworld_release) {
+            fprintf(stderr, "critical symbol wasn't loaded\n");
+            return 1;
+        }
+
+        /* wrapper functions don't wait for the background thread */
+        helloworld_hello2(hw, cb);
+
+        /* free the library while the background thread may still be running */
+        if (i == 1) {
+            helloworld_release(hw);
+            gdo_free_lib();
+            continue;
+        }
+
+        const time_t start = time(NULL);
+
+        while (!gdo_all_symbols_loaded()) {
+            if (time(NULL) - start > 10) {
+                fprintf(stderr, "symbols weren't loaded in the background\n");
+                return 1;
+            }
+        }
+
+        helloworld_callback = cb;
+        helloworld_hello(hw);
+        helloworld_release(hw);
+
+        gdo_free_lib();
+    }
+
+    return 0;
+}
@@ -0,0 +1,76 @@
+#include <pthread.h>
+#include <stdio.h>
+#include "helloworld.h"
+
+/* enable automatic loading of each symbol when it's first used */
+#define GDO_ENABLE_AUTOLOAD 1
+#define GDO_ENABLE_AUTOLOAD_LAZY 1
+
+/* define a default library to load; this is required */
+#define GDO_DEFAULT_LIB GDO_LIBNAME(helloworld,0)
+
+/* include generated header file */
+#include "c_autoload_threads.h"
+
+#define NUM_THREADS  8
+#define NUM_LOOPS    1000
+
+
+pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t cond = PTHREAD_COND_INITIALIZER;
+int start = 0;
+
+
+void cb(const char *msg)
+{
+    (void)msg;
+}
+
+void *run(void *arg)
+{
+    (void)arg;
+
+    /* wait until all threads were created */
+    pthread_mutex_lock(&mutex);
+
+    while (!start) {
+        pthread_cond_wait(&cond, &mutex);
+    }
+
+    pthread_mutex_unlock(&mutex);
+
+    /* all threads will call the wrapper functions at the same time,
+     * which will load the library and symbols on first use */
+    for (int i = 0; i < NUM_LOOPS; i++) {
+        helloworld *hw = helloworld_init();
+        helloworld_hello2(hw, cb);
+        helloworld_release(hw);
+    }
+
+    return NULL;
+}
+
+int main()
+{
+    pthread_t t[NUM_THREADS];
+
+    for (int i = 0; i < NUM_THREADS; i++) {
+        if (pthread_create(&t[i], NULL, run, NULL) != 0) {
+            fprintf(stderr, "pthread_create() failed\n");
+            return 1;
+        }
+    }
+
+    pthread_mutex_lock(&mutex);
+    start = 1;
+    pthread_cond_broadcast(&cond);
+    pthread_mutex_unlock(&mutex);
+
+    for (int i = 0; i < NUM_THREADS; i++) {
+        pthread_join(t[i], NULL);
+    }
+
+    puts("all threads finished");
+
+    return 0;
+}
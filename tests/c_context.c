@@ -0,0 +1,84 @@
+#include <stdio.h>
+#include <string.h>
+#include "helloworld.h"
+
+/* include generated header file */
+#include "c_context.h"
+
+
+void cb_a(const char *msg)
+{
+    printf("context A >>> %s\n", msg);
+}
+
+void cb_b(const char *msg)
+{
+    printf("context B >>> %s\n", msg);
+}
+
+int main()
+{
+    gdo_ctx_t a, b;
+    bool new_namespace = false;
+
+#ifdef GDO_HAVE_DLMOPEN
+    new_namespace = true;
+#endif
+
+    /* loading must fail without changing anything else */
+    if (gdo_ctx_load(&a, GDO_LIBNAME(nonexistent,0), GDO_DEFAULT_FLAGS, false) ||
+        a.handle != NULL || gdo_ctx_last_error(&a)[0] == 0)
+    {
+        fprintf(stderr, "loading a nonexistent library didn't fail\n");
+        return 1;
+    }
+
+    printf("expected error: %s\n", gdo_ctx_last_error(&a));
+
+    /* load two instances of the library */
+    if (!gdo_ctx_load(&a, GDO_LIBNAME(helloworld,0), GDO_DEFAULT_FLAGS, false)) {
+        fprintf(stderr, "%s\n", gdo_ctx_last_error(&a));
+        return 1;
+    }
+
+    if (!gdo_ctx_load(&b, GDO_LIBNAME(helloworld,0), GDO_DEFAULT_FLAGS, new_namespace)) {
+        fprintf(stderr, "%s\n", gdo_ctx_last_error(&b));
+        gdo_ctx_free(&a);
+        return 1;
+    }
+
+    /* objects of a library loaded into a new namespace are separate copies */
+    if (new_namespace &&
+        GDO_CTX(&a, helloworld_buffer) == GDO_CTX(&b, helloworld_buffer))
+    {
+        fprintf(stderr, "library wasn't loaded into a new namespace\n");
+        return 1;
+    }
+
+    /* call functions through the symbol tables */
+    *GDO_CTX(&a, helloworld_callback) = cb_a;
+    *GDO_CTX(&b, helloworld_callback) = cb_b;
+
+    helloworld *hw_a = GDO_CTX(&a, helloworld_init)();
+    helloworld *hw_b = GDO_CTX(&b, helloworld_init)();
+
+    GDO_CTX(&a, helloworld_hello)(hw_a);
+    GDO_CTX(&b, helloworld_hello)(hw_b);
+    GDO_CTX(&a, helloworld_fprintf)(stdout, "%s\n", "variable arguments");
+
+    GDO_CTX(&a, helloworld_release)(hw_a);
+    GDO_CTX(&b, helloworld_release)(hw_b);
+
+    /* free resources */
+    if (!gdo_ctx_free(&a) || !gdo_ctx_free(&b)) {
+        fprintf(stderr, "%s\n", gdo_ctx_last_error(&a));
+        return 1;
+    }
+
+    if (a.handle != NULL || GDO_CTX(&a, helloworld_init) != NULL) {
+        fprintf(stderr, "context wasn't reset\n");
+        return 1;
+    }
+
+    return 0;
+}
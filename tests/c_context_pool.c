@@ -0,0 +1,124 @@
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include "helloworld.h"
+
+/* include generated header file */
+#include "c_context_pool.h"
+
+#define NUM_THREADS  8
+#define NUM_LOOPS    1000
+
+#ifdef GDO_HAVE_DLMOPEN
+# define POOL_SIZE   4
+#else
+# define POOL_SIZE   1
+#endif
+
+
+gdo_pool_t pool;
+int failed = 0;
+
+
+void cb(const char *msg)
+{
+    (void)msg;
+}
+
+void *run(void *arg)
+{
+    char id[16];
+
+    snprintf(id, sizeof(id), "thread %ld", (long)arg);
+
+    for (int i = 0; i < NUM_LOOPS; i++) {
+        gdo_ctx_t *ctx = gdo_pool_acquire(&pool);
+
+        /* the global data of an instance is only used by one thread at a time */
+        char *buf = (char *)GDO_CTX(ctx, helloworld_buffer);
+        snprintf(buf, 64, "%s", id);
+
+        *GDO_CTX(ctx, helloworld_callback) = cb;
+        helloworld *hw = GDO_CTX(ctx, helloworld_init)();
+        GDO_CTX(ctx, helloworld_hello)(hw);
+        GDO_CTX(ctx, helloworld_release)(hw);
+
+        if (strcmp(buf, id) != 0) {
+            __atomic_store_n(&failed, 1, __ATOMIC_RELAXED);
+        }
+
+        gdo_pool_release(&pool, ctx);
+    }
+
+    return NULL;
+}
+
+int main()
+{
+    pthread_t t[NUM_THREADS];
+
+    /* loading must fail without changing anything else */
+    if (gdo_pool_load(&pool, POOL_SIZE, GDO_LIBNAME(nonexistent,0), GDO_DEFAULT_FLAGS) ||
+        pool.size != 0 || gdo_pool_acquire(&pool) != NULL)
+    {
+        fprintf(stderr, "loading a nonexistent library didn't fail\n");
+        return 1;
+    }
+
+    printf("expected error: %s\n", gdo_pool_last_error(&pool));
+
+    if (!gdo_pool_load(&pool, POOL_SIZE, GDO_LIBNAME(helloworld,0), GDO_DEFAULT_FLAGS)) {
+        fprintf(stderr, "%s\n", gdo_pool_last_error(&pool));
+        return 1;
+    }
+
+    /* each instance has its own copy of the global data */
+    for (int i = 1; i < pool.size; i++) {
+        if (GDO_CTX(&pool.ctx[i], helloworld_buffer) == GDO_CTX(&pool.ctx[0], helloworld_buffer)) {
+            fprintf(stderr, "instances share their global data\n");
+            return 1;
+        }
+    }
+
+    /* all instances are borrowed */
+    gdo_ctx_t *ctx[POOL_SIZE];
+
+    for (int i = 0; i < POOL_SIZE; i++) {
+        ctx[i] = gdo_pool_try_acquire(&pool);
+    }
+
+    if (gdo_pool_try_acquire(&pool) != NULL) {
+        fprintf(stderr, "more instances borrowed than loaded\n");
+        return 1;
+    }
+
+    for (int i = 0; i < POOL_SIZE; i++) {
+        gdo_pool_release(&pool, ctx[i]);
+    }
+
+    /* more threads than instances */
+    for (long i = 0; i < NUM_THREADS; i++) {
+        if (pthread_create(&t[i], NULL, run, (void *)i) != 0) {
+            fprintf(stderr, "pthread_create() failed\n");
+            return 1;
+        }
+    }
+
+    for (int i = 0; i < NUM_THREADS; i++) {
+        pthread_join(t[i], NULL);
+    }
+
+    if (failed) {
+        fprintf(stderr, "an instance was used by two threads at the same time\n");
+        return 1;
+    }
+
+    printf("%d threads used %d instances\n", NUM_THREADS, pool.size);
+
+    if (!gdo_pool_free(&pool)) {
+        fprintf(stderr, "%s\n", gdo_pool_last_error(&pool));
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,54 @@
+#include <stdio.h>
+#include "helloworld.h"
+
+/* resolve symbols from the ELF hash table */
+#define GDO_USE_ELF_RESOLVER 1
+
+/* include generated header file */
+#include "c_elf_resolver.h"
+
+
+void cb(const char *msg)
+{
+    puts(msg);
+}
+
+int main()
+{
+    /* load library and symbols */
+    if (!gdo_load_lib_name_and_symbols(GDO_LIBNAME(helloworld,0))) {
+        fprintf(stderr, "%s\n", gdo_last_error());
+        gdo_free_lib();
+        return 1;
+    }
+
+#ifndef _WIN32
+    /* compare with the addresses returned by dlsym() */
+    void *handle = dlopen(GDO_LIBNAME(helloworld,0), RTLD_NOW);
+
+    if (!handle ||
+        dlsym(handle, "helloworld_init")     != (void *)GDO_RAWPTR_helloworld_init ||
+        dlsym(handle, "helloworld_hello")    != (void *)GDO_RAWPTR_helloworld_hello ||
+        dlsym(handle, "helloworld_callback") != (void *)GDO_RAWPTR_helloworld_callback ||
+        dlsym(handle, "helloworld_buffer")   != (void *)GDO_RAWPTR_helloworld_buffer ||
+        dlsym(handle, "helloworld_release")  != (void *)GDO_RAWPTR_helloworld_release)
+    {
+        fprintf(stderr, "symbol address mismatch\n");
+        gdo_free_lib();
+        return 1;
+    }
+
+    dlclose(handle);
+#endif
+
+    /* our code */
+    helloworld *hw = helloworld_init();
+    helloworld_callback = cb;
+    helloworld_hello(hw);
+    helloworld_release(hw);
+
+    /* free resources */
+    gdo_free_lib();
+
+    return 0;
+}
@@ -0,0 +1,73 @@
+#include <stdio.h>
+#include <string.h>
+#include "helloworld.h"
+
+/* remap the library code onto huge pages */
+#define GDO_REMAP_HUGE_TEXT 1
+
+/* report the remapped size */
+#define GDO_ENABLE_LOAD_STATS 1
+
+/* include generated header file */
+#include "c_huge_text.h"
+
+
+void cb(const char *msg)
+{
+    printf("Custom callback >>> %s\n", msg);
+}
+
+#ifdef GDO_HAVE_HUGE_TEXT
+/* copy of the library with 4 MB of code aligned to a huge page */
+# define LIBNAME GDO_LIBNAME(helloworld_big,0)
+
+/* transparent huge pages are enabled unless set to `never' */
+static int thp_enabled(void)
+{
+    char buf[128] = {0};
+    FILE *fp = fopen("/sys/kernel/mm/transparent_hugepage/enabled", "r");
+
+    if (!fp) {
+        return 0;
+    }
+
+    const char *line = fgets(buf, sizeof(buf), fp);
+    fclose(fp);
+
+    return (line && !strstr(line, "[never]"));
+}
+#else
+# define LIBNAME GDO_LIBNAME(helloworld,0)
+#endif
+
+int main()
+{
+    gdo_load_stats_t stats;
+
+    if (!gdo_load_lib_name_and_symbols(LIBNAME)) {
+        fprintf(stderr, "%s\n", gdo_last_error());
+        gdo_free_lib();
+        return 1;
+    }
+
+    gdo_get_load_stats(&stats);
+
+    printf("remapped onto huge pages: %llu bytes\n", (unsigned long long)stats.huge_text);
+
+#ifdef GDO_HAVE_HUGE_TEXT
+    if (stats.huge_text == 0 && thp_enabled()) {
+        fprintf(stderr, "no code was remapped\n");
+        gdo_free_lib();
+        return 1;
+    }
+#endif
+
+    /* code must still be callable */
+    helloworld *hw = helloworld_init();
+    helloworld_hello2(hw, cb);
+    helloworld_release(hw);
+
+    gdo_free_lib();
+
+    return 0;
+}
@@ -0,0 +1,125 @@
+#include <dlfcn.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <time.h>
+#include "helloworld.h"
+
+/* free the library after it wasn't used for 100 milliseconds */
+#define GDO_ENABLE_AUTOLOAD 1
+#define GDO_ENABLE_IDLE_UNLOAD 1
+#define GDO_IDLE_TIMEOUT 100
+
+/* define a default library to load; this is required */
+#define GDO_DEFAULT_LIB GDO_LIBNAME(helloworld,0)
+
+/* include generated header file */
+#include "c_idle_unload.h"
+
+#define NUM_THREADS  4
+#define NUM_BURSTS   4
+
+
+void cb(const char *msg)
+{
+    (void)msg;
+}
+
+void sleep_ms(long ms)
+{
+    struct timespec ts = { ms / 1000, (ms % 1000) * 1000000L };
+    nanosleep(&ts, NULL);
+}
+
+/* check if the library is mapped without loading it */
+int lib_mapped()
+{
+    void *handle = dlopen(GDO_DEFAULT_LIB, RTLD_LAZY | RTLD_NOLOAD);
+
+    if (handle) {
+        dlclose(handle);
+        return 1;
+    }
+
+    return 0;
+}
+
+/* wait up to 5 seconds for the library to be freed */
+int wait_unmapped()
+{
+    for (int i = 0; i < 500; i++) {
+        if (!lib_mapped()) {
+            return 1;
+        }
+        sleep_ms(10);
+    }
+
+    return 0;
+}
+
+void call_functions()
+{
+    helloworld *hw = helloworld_init();
+    helloworld_hello2(hw, cb);
+    helloworld_release(hw);
+}
+
+void *run(void *arg)
+{
+    const long id = (long)arg;
+
+    /* bursts of calls separated by pauses longer than the timeout,
+     * the library is freed and loaded again while other threads use it */
+    for (int i = 0; i < NUM_BURSTS; i++) {
+        for (int j = 0; j < 1000; j++) {
+            call_functions();
+        }
+        sleep_ms(350 + 25 * id);
+    }
+
+    return NULL;
+}
+
+int main()
+{
+#ifdef GDO_HAVE_IDLE_UNLOAD
+    pthread_t t[NUM_THREADS];
+
+    for (long i = 0; i < NUM_THREADS; i++) {
+        if (pthread_create(&t[i], NULL, run, (void *)i) != 0) {
+            fprintf(stderr, "pthread_create() failed\n");
+            return 1;
+        }
+    }
+
+    for (int i = 0; i < NUM_THREADS; i++) {
+        pthread_join(t[i], NULL);
+    }
+
+    /* freed by the idle thread */
+    if (!wait_unmapped()) {
+        fprintf(stderr, "library wasn't freed after the idle timeout\n");
+        return 1;
+    }
+
+    /* loaded again on the next call */
+    call_functions();
+
+    if (!lib_mapped()) {
+        fprintf(stderr, "library wasn't loaded again\n");
+        return 1;
+    }
+
+    /* free it right away */
+    if (!gdo_unload_if_idle() || lib_mapped()) {
+        fprintf(stderr, "gdo_unload_if_idle(): %s\n", gdo_last_error());
+        return 1;
+    }
+
+    call_functions();
+    puts("library was freed while idle and loaded again");
+#else
+    puts("freeing an idle library is not supported");
+#endif
+
+    return 0;
+}
@@ -0,0 +1,38 @@
+/* the generated auto-loading code is linked in form of a shared library
+ * that exports its wrapper functions as indirect functions */
+
+#include <stdio.h>
+#include <dlfcn.h>
+#include "helloworld.h"
+
+
+void cb(const char *msg)
+{
+    puts(msg);
+}
+
+int main()
+{
+    helloworld *hw = helloworld_init();
+    helloworld_hello2(hw, cb);
+    helloworld_release(hw);
+
+    /* the IFUNC resolver returned the library's function */
+    void *self = dlopen(NULL, RTLD_LAZY);
+    void *lib = dlopen(LIBNAME, RTLD_LAZY | RTLD_NOLOAD);
+
+    if (!self || !lib) {
+        fprintf(stderr, "%s\n", dlerror());
+        return 1;
+    }
+
+    if (dlsym(self, "helloworld_init") != dlsym(lib, "helloworld_init")) {
+        fprintf(stderr, "helloworld_init() wasn't bound to the library\n");
+        return 1;
+    }
+
+    dlclose(lib);
+    dlclose(self);
+
+    return 0;
+}
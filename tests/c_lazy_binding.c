@@ -0,0 +1,57 @@
+#include <stdio.h>
+#include "helloworld.h"
+
+/* enable automatic loading of each symbol when it's first used */
+#define GDO_ENABLE_AUTOLOAD 1
+#define GDO_ENABLE_AUTOLOAD_LAZY 1
+
+/* call symbols through pointers to resolver stubs */
+#define GDO_ENABLE_LAZY_BINDING 1
+
+/* define a default library to load; this is required */
+#define GDO_DEFAULT_LIB GDO_LIBNAME(helloworld,0)
+
+/* functions with a hook are still checked on every call */
+#define GDO_HOOK_helloworld_hello2(...) \
+    puts("helloworld_hello2() function hooked!");
+
+/* include generated header file */
+#include "c_lazy_binding.h"
+
+
+void cb(const char *msg)
+{
+    printf("Custom callback >>> %s\n", msg);
+}
+
+int main()
+{
+    helloworld *(*stub)(void) = _gdo_lazy_ptr_helloworld_init;
+
+    for (int i = 0; i < 2; i++) {
+        /* call pointer must be a resolver stub */
+        if (GDO_RAWPTR_helloworld_init != NULL ||
+            _gdo_lazy_ptr_helloworld_init != stub)
+        {
+            fprintf(stderr, "call pointer wasn't reset\n");
+            return 1;
+        }
+
+        helloworld *hw = helloworld_init();
+
+        /* call pointer must now be the symbol */
+        if (_gdo_lazy_ptr_helloworld_init != GDO_RAWPTR_helloworld_init) {
+            fprintf(stderr, "call pointer wasn't replaced\n");
+            return 1;
+        }
+
+        helloworld_hello2(hw, cb);
+        helloworld_fprintf(stdout, "%s\n", "variable arguments");
+        helloworld_release(hw);
+
+        /* pointers are set back to the resolver stubs */
+        gdo_free_lib();
+    }
+
+    return 0;
+}
@@ -0,0 +1,105 @@
+#include <dlfcn.h>
+#include <stdio.h>
+#include "helloworld.h"
+
+/* include generated header file */
+#include "c_library_map.h"
+
+
+int called = 0;
+
+
+void cb(const char *msg)
+{
+    puts(msg);
+    called = 1;
+}
+
+/* check if a library is mapped without loading it */
+int lib_mapped(const char *filename)
+{
+    void *handle = dlopen(filename, RTLD_LAZY | RTLD_NOLOAD);
+
+    if (handle) {
+        dlclose(handle);
+        return 1;
+    }
+
+    return 0;
+}
+
+int main()
+{
+    const char *copy = GDO_LIBNAME(helloworld_copy,0);
+
+    /* the other libraries are freed if the main library fails to load */
+    if (gdo_load_lib_name(GDO_LIBNAME(nonexistent,0)) || lib_mapped(copy)) {
+        fprintf(stderr, "libraries were loaded partially\n");
+        return 1;
+    }
+
+    printf("expected error: %s\n", gdo_last_error());
+
+    /* both libraries are loaded together */
+    if (!gdo_load_lib_name(GDO_LIBNAME(helloworld,0)) || !lib_mapped(copy)) {
+        fprintf(stderr, "%s\n", gdo_last_error());
+        return 1;
+    }
+
+    /* symbols of one library */
+    if (gdo_library_symbols_loaded_copy() || !gdo_load_library_symbols_copy() ||
+        !gdo_library_symbols_loaded_copy() ||
+        gdo_library_symbols_loaded(GDO_LIBRARY_MAIN) || GDO_RAWPTR_helloworld_init ||
+        gdo_all_symbols_loaded())
+    {
+        fprintf(stderr, "wrong symbols were loaded\n");
+        gdo_free_lib();
+        return 1;
+    }
+
+    if (gdo_load_library_symbols(GDO_LIBRARY_COUNT)) {
+        fprintf(stderr, "unknown library was loaded\n");
+        gdo_free_lib();
+        return 1;
+    }
+
+    printf("expected error: %s\n", gdo_last_error());
+
+    if (!gdo_load_all_symbols() || !gdo_library_symbols_loaded(GDO_LIBRARY_MAIN)) {
+        fprintf(stderr, "%s\n", gdo_last_error());
+        gdo_free_lib();
+        return 1;
+    }
+
+    /* each symbol was looked up in its own library */
+    void *handle = dlopen(copy, RTLD_LAZY);
+
+    if (!handle || dlsym(handle, "helloworld_hello2") != (void *)GDO_RAWPTR_helloworld_hello2 ||
+        dlsym(handle, "helloworld_init") == (void *)GDO_RAWPTR_helloworld_init)
+    {
+        fprintf(stderr, "symbols were looked up in the wrong library\n");
+        gdo_free_lib();
+        return 1;
+    }
+
+    dlclose(handle);
+
+    /* helloworld_hello() uses the callback pointer of the same library */
+    helloworld *hw = helloworld_init();
+    helloworld_callback = cb;
+    helloworld_hello(hw);
+    helloworld_release(hw);
+
+    if (!called) {
+        fprintf(stderr, "callback wasn't called\n");
+        gdo_free_lib();
+        return 1;
+    }
+
+    if (!gdo_free_lib() || lib_mapped(copy)) {
+        fprintf(stderr, "library wasn't freed\n");
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,50 @@
+#include <stdio.h>
+#include <string.h>
+#include "helloworld.h"
+
+/* include generated header file */
+#include "c_load_memory.h"
+
+
+void cb(const char *msg)
+{
+    printf("Custom callback >>> %s\n", msg);
+}
+
+int main()
+{
+#ifdef GDO_HAVE_LOAD_MEMORY
+    const char garbage[] = "not a library";
+
+    if (gdo_load_lib_memory(garbage, sizeof(garbage), GDO_DEFAULT_FLAGS, false)) {
+        fprintf(stderr, "loaded an invalid library image\n");
+        return 1;
+    }
+
+    printf("expected error: %s\n", gdo_last_error());
+
+    /* load twice to check that a freed library isn't mistaken for the new one */
+    for (int i = 0; i < 2; i++) {
+        if (!gdo_load_lib_embedded() || !gdo_load_all_symbols()) {
+            fprintf(stderr, "%s\n", gdo_last_error());
+            gdo_free_lib();
+            return 1;
+        }
+
+        printf("library path: %s\n", gdo_library_path());
+
+        helloworld *hw = helloworld_init();
+        helloworld_hello2(hw, cb);
+        helloworld_release(hw);
+
+        if (!gdo_free_lib()) {
+            fprintf(stderr, "%s\n", gdo_last_error());
+            return 1;
+        }
+    }
+#else
+    puts("loading from memory is not supported on this system");
+#endif
+
+    return 0;
+}
@@ -0,0 +1,84 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "helloworld.h"
+
+#ifdef __linux__
+# include <unistd.h>
+#endif
+
+/* collect load diagnostics */
+#define GDO_ENABLE_LOAD_STATS 1
+
+/* include generated header file */
+#include "c_load_stats.h"
+
+
+int main()
+{
+    gdo_load_stats_t stats;
+
+    if (!gdo_load_lib_name_and_symbols(GDO_LIBNAME(helloworld,0))) {
+        fprintf(stderr, "%s\n", gdo_last_error());
+        gdo_free_lib();
+        return 1;
+    }
+
+    gdo_get_load_stats(&stats);
+
+    printf("load time:      %llu ns\n", (unsigned long long)stats.load_time_ns);
+    printf("new objects:    %ld\n", stats.new_objects);
+    printf("symbol lookups: %llu (%llu failed) in %llu ns\n",
+        (unsigned long long)stats.sym_lookups,
+        (unsigned long long)stats.sym_failed,
+        (unsigned long long)stats.sym_time_ns);
+
+    if (stats.load_time_ns == 0 || stats.new_objects == 0 ||
+        stats.sym_lookups != GDO_ENUM_LAST || stats.sym_failed != 0)
+    {
+        fprintf(stderr, "unexpected load statistics\n");
+        gdo_free_lib();
+        return 1;
+    }
+
+#ifdef __linux__
+    /* a relative path is resolved to the full library path */
+    const char *path = gdo_library_path();
+    char *fullpath = path ? strdup(path) : NULL;
+    char *sep = fullpath ? strrchr(fullpath, '/') : NULL;
+
+    if (!sep) {
+        fprintf(stderr, "no full library path: %s\n", gdo_last_error());
+        free(fullpath);
+        gdo_free_lib();
+        return 1;
+    }
+
+    gdo_free_lib();
+
+    *sep = 0;
+
+    if (chdir(fullpath) != 0 || !gdo_load_lib_name("./" GDO_LIBNAME(helloworld,0))) {
+        fprintf(stderr, "failed to load library from `%s'\n", fullpath);
+        free(fullpath);
+        return 1;
+    }
+
+    *sep = '/';
+    path = gdo_library_path();
+
+    if (!path || strcmp(path, fullpath) != 0) {
+        fprintf(stderr, "wrong library path: %s\n", path ? path : gdo_last_error());
+        free(fullpath);
+        gdo_free_lib();
+        return 1;
+    }
+
+    printf("library path:   %s\n", path);
+    free(fullpath);
+#endif
+
+    gdo_free_lib();
+
+    return 0;
+}
@@ -0,0 +1,130 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "helloworld.h"
+
+#ifdef __linux__
+# include <fcntl.h>
+# include <time.h>
+# include <unistd.h>
+#endif
+
+/* read the library into the page cache before loading it */
+#define GDO_PREFETCH 1
+
+/* measure load times */
+#define GDO_ENABLE_LOAD_STATS 1
+
+/* include generated header file */
+#include "c_prefetch.h"
+
+
+/* load and free the library, return the load time */
+static unsigned long long load_time(void)
+{
+    gdo_load_stats_t stats;
+
+    if (!gdo_load_lib_name_and_symbols(GDO_LIBNAME(helloworld,0))) {
+        fprintf(stderr, "%s\n", gdo_last_error());
+        exit(1);
+    }
+
+    gdo_get_load_stats(&stats);
+    gdo_free_lib();
+
+    return (unsigned long long)stats.load_time_ns;
+}
+
+
+#ifdef GDO_HAVE_PREFETCH
+/* drop the unmapped library from the page cache to measure a cold load;
+ * this has no effect on pages used by other processes */
+static void drop_cache(const char *path)
+{
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+
+    if (fd != -1) {
+        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        close(fd);
+    }
+}
+
+/* load and free the library with dlopen(), without any prefetching */
+static unsigned long long dlopen_time(const char *path)
+{
+    struct timespec start, end;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    void *handle = dlopen(path, RTLD_NOW);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    if (!handle) {
+        fprintf(stderr, "%s\n", dlerror());
+        exit(1);
+    }
+
+    dlclose(handle);
+
+    return (unsigned long long)(end.tv_sec - start.tv_sec) * 1000000000ULL +
+        (unsigned long long)end.tv_nsec - (unsigned long long)start.tv_nsec;
+}
+#endif
+
+
+int main()
+{
+#ifdef GDO_HAVE_PREFETCH
+    char *path;
+
+    if (gdo_prefetch("libnonexistent.so.0")) {
+        fprintf(stderr, "prefetched a nonexistent library\n");
+        return 1;
+    }
+
+    if (!gdo_prefetch(GDO_LIBNAME(helloworld,0))) {
+        fprintf(stderr, "library wasn't found\n");
+        return 1;
+    }
+
+    /* get the library path */
+    if (!gdo_load_lib_name(GDO_LIBNAME(helloworld,0)) ||
+        !(path = strdup(gdo_library_path())))
+    {
+        fprintf(stderr, "%s\n", gdo_last_error());
+        gdo_free_lib();
+        return 1;
+    }
+
+    gdo_free_lib();
+
+    /* cold loads without and with prefetching right before loading */
+    drop_cache(path);
+    unsigned long long cold = dlopen_time(path);
+    drop_cache(path);
+    unsigned long long inline_prefetch = load_time();
+
+    /* cold load after an early prefetch, which isn't repeated by the load */
+    drop_cache(path);
+
+    if (!gdo_prefetch(GDO_LIBNAME(helloworld,0))) {
+        fprintf(stderr, "library wasn't found\n");
+        free(path);
+        return 1;
+    }
+
+    usleep(20000); /* other startup work */
+    unsigned long long early_prefetch = load_time();
+
+    printf("library:                    %s\n", path);
+    printf("cold load without prefetch: %llu ns\n", cold);
+    printf("cold load with prefetch:    %llu ns\n", inline_prefetch);
+    printf("cold load, early prefetch:  %llu ns\n", early_prefetch);
+
+    free(path);
+#else
+    /* no prefetching on this system */
+    printf("load: %llu ns\n", load_time());
+#endif
+
+    return 0;
+}
@@ -0,0 +1,51 @@
+#include <stddef.h>
+#include <stdio.h>
+#include "helloworld.h"
+
+/* use wrap functions that will warn and exit
+ * if the symbol wasn't loaded yet */
+#define GDO_WRAP_FUNCTIONS 1
+
+#define GDO_DEFAULT_LIB GDO_LIBNAME(helloworld,0)
+
+/* include generated header file */
+#include "c_profile.h"
+
+
+void cb(const char *msg)
+{
+    puts(msg);
+}
+
+int main()
+{
+    /* symbols must be ordered by call count */
+    if (GDO_LOAD_helloworld_hello != 0 ||
+        GDO_LOAD_helloworld_hello2 != 1 ||
+        offsetof(gdo_handle_t, GDO_PTR_helloworld_hello) != 0 ||
+        offsetof(gdo_handle_t, GDO_PTR_helloworld_hello2) != sizeof(void *))
+    {
+        fprintf(stderr, "symbols were not ordered by the profile\n");
+        return 1;
+    }
+
+    /* load library and symbols */
+    if (!gdo_load_lib_and_symbols()) {
+        fprintf(stderr, "%s\n", gdo_last_error());
+        gdo_free_lib();
+        return 1;
+    }
+
+    /* our code */
+    helloworld *hw = helloworld_init();
+    helloworld_callback = cb;
+    helloworld_hello(hw);
+    helloworld_hello2(hw, cb);
+    helloworld_fprintf(stdout, "%s\n", "variable arguments");
+    helloworld_release(hw);
+
+    /* free resources */
+    gdo_free_lib();
+
+    return 0;
+}
@@ -0,0 +1,44 @@
+#include <stdio.h>
+#include "helloworld.h"
+
+/* enable automatic loading of each symbol when it's first used */
+#define GDO_ENABLE_AUTOLOAD_LAZY 1
+
+/* define a default library to load; this is required */
+#define GDO_DEFAULT_LIB GDO_LIBNAME(helloworld,0)
+
+/* include generated header file */
+#include "c_profile_autoload.h"
+
+
+void cb(const char *msg)
+{
+    puts(msg);
+}
+
+int main()
+{
+    helloworld *hw = helloworld_init();
+
+    /* symbols with a call count in the profile are loaded eagerly */
+    if (!GDO_RAWPTR_helloworld_hello || !GDO_RAWPTR_helloworld_hello2 ||
+        !GDO_RAWPTR_helloworld_release)
+    {
+        fprintf(stderr, "symbols from the profile weren't loaded\n");
+        return 1;
+    }
+
+    /* all other symbols are loaded lazily */
+    if (GDO_RAWPTR_helloworld_fprintf || gdo_all_symbols_loaded()) {
+        fprintf(stderr, "symbol not in the profile was loaded\n");
+        return 1;
+    }
+
+    helloworld_hello2(hw, cb);
+    helloworld_fprintf(stdout, "%s\n", "variable arguments");
+    helloworld_release(hw);
+
+    gdo_free_lib();
+
+    return 0;
+}
@@ -0,0 +1,73 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "helloworld.h"
+
+/* count wrapper function calls and save them upon exit */
+#define GDO_RECORD_PROFILE "c_record_profile.txt"
+
+/* enable automatic loading of each symbol when it's first used */
+#define GDO_ENABLE_AUTOLOAD_LAZY 1
+
+/* define a default library to load; this is required */
+#define GDO_DEFAULT_LIB GDO_LIBNAME(helloworld,0)
+
+/* include generated header file */
+#include "c_record_profile.h"
+
+
+void cb(const char *msg)
+{
+    puts(msg);
+}
+
+/* registered before the profile is saved, so it's called after it */
+void check_profile(void)
+{
+    const char *expected =
+        "helloworld_init 1\n"
+        "helloworld_hello2 3\n"
+        "helloworld_fprintf 1\n"
+        "helloworld_release 1\n";
+
+    char buf[256];
+    char lines[256] = {0};
+    FILE *fp = fopen(GDO_RECORD_PROFILE, "r");
+
+    if (!fp) {
+        perror("fopen()");
+        _Exit(1);
+    }
+
+    while (fgets(buf, sizeof(buf), fp)) {
+        if (buf[0] != '#' && strlen(lines) + strlen(buf) < sizeof(lines)) {
+            strcat(lines, buf);
+        }
+    }
+
+    fclose(fp);
+
+    if (strcmp(lines, expected) != 0) {
+        fprintf(stderr, "unexpected profile:\n%s", lines);
+        _Exit(1);
+    }
+
+    printf("recorded profile:\n%s", lines);
+}
+
+int main()
+{
+    remove(GDO_RECORD_PROFILE);
+    atexit(check_profile);
+
+    helloworld *hw = helloworld_init();
+
+    for (int i = 0; i < 3; i++) {
+        helloworld_hello2(hw, cb);
+    }
+
+    helloworld_fprintf(stdout, "%s\n", "variable arguments");
+    helloworld_release(hw);
+
+    return 0;
+}
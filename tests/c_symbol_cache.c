@@ -0,0 +1,92 @@
+#include <stdio.h>
+#include "helloworld.h"
+
+/* save symbol offsets in a cache file */
+#define GDO_SYMBOL_CACHE "c_symbol_cache.cache"
+
+/* count the symbol lookups */
+#define GDO_ENABLE_LOAD_STATS 1
+
+/* include generated header file */
+#include "c_symbol_cache.h"
+
+
+void cb(const char *msg)
+{
+    puts(msg);
+}
+
+/* `lookups' is the expected total number of symbol lookups */
+int load_and_run(int lookups)
+{
+    /* load library and symbols */
+    if (!gdo_load_lib_name_and_symbols(GDO_LIBNAME(helloworld,0))) {
+        fprintf(stderr, "%s\n", gdo_last_error());
+        gdo_free_lib();
+        return 1;
+    }
+
+#ifdef GDO_HAVE_SYMBOL_CACHE
+    gdo_load_stats_t stats;
+    gdo_get_load_stats(&stats);
+
+    if (stats.sym_lookups != (uint64_t)lookups) {
+        fprintf(stderr, "%llu symbol lookups, expected %d\n",
+            (unsigned long long)stats.sym_lookups, lookups);
+        gdo_free_lib();
+        return 1;
+    }
+#else
+    (void)lookups;
+#endif
+
+#ifndef _WIN32
+    /* compare with the addresses returned by dlsym() */
+    void *handle = dlopen(GDO_LIBNAME(helloworld,0), RTLD_NOW);
+
+    if (!handle ||
+        dlsym(handle, "helloworld_init")     != (void *)GDO_RAWPTR_helloworld_init ||
+        dlsym(handle, "helloworld_hello")    != (void *)GDO_RAWPTR_helloworld_hello ||
+        dlsym(handle, "helloworld_callback") != (void *)GDO_RAWPTR_helloworld_callback ||
+        dlsym(handle, "helloworld_buffer")   != (void *)GDO_RAWPTR_helloworld_buffer ||
+        dlsym(handle, "helloworld_release")  != (void *)GDO_RAWPTR_helloworld_release)
+    {
+        fprintf(stderr, "symbol address mismatch\n");
+        gdo_free_lib();
+        return 1;
+    }
+
+    dlclose(handle);
+#endif
+
+    /* our code */
+    helloworld *hw = helloworld_init();
+    helloworld_callback = cb;
+    helloworld_hello(hw);
+    helloworld_release(hw);
+
+    /* free resources */
+    gdo_free_lib();
+
+    return 0;
+}
+
+int main()
+{
+    /* stale cache file */
+    FILE *fp = fopen(GDO_SYMBOL_CACHE, "wb");
+
+    if (fp) {
+        fputs("invalid data", fp);
+        fclose(fp);
+    }
+
+    /* 1st: create cache file; 2nd: use cache file without any lookups */
+    if (load_and_run(GDO_ENUM_LAST) != 0 || load_and_run(GDO_ENUM_LAST) != 0) {
+        return 1;
+    }
+
+    remove(GDO_SYMBOL_CACHE);
+
+    return 0;
+}
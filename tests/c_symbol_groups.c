@@ -0,0 +1,68 @@
+#include <stdio.h>
+#include "helloworld.h"
+
+/* include generated header file */
+#include "c_symbol_groups.h"
+
+
+void cb(const char *msg)
+{
+    puts(msg);
+}
+
+int main()
+{
+    if (!gdo_load_lib_name(GDO_LIBNAME(helloworld,0))) {
+        fprintf(stderr, "%s\n", gdo_last_error());
+        return 1;
+    }
+
+    /* group "lifetime" was declared with two prefixes */
+    if (gdo_group_loaded_lifetime() || !gdo_load_group_lifetime() ||
+        !gdo_group_loaded_lifetime())
+    {
+        fprintf(stderr, "%s\n", gdo_last_error());
+        gdo_free_lib();
+        return 1;
+    }
+
+    /* symbols of other groups are not loaded */
+    if (gdo_group_loaded(GDO_GROUP_hello) || GDO_RAWPTR_helloworld_hello ||
+        !GDO_RAWPTR_helloworld_init_argv || gdo_all_symbols_loaded())
+    {
+        fprintf(stderr, "wrong symbols were loaded\n");
+        gdo_free_lib();
+        return 1;
+    }
+
+    if (gdo_load_group(GDO_GROUP_COUNT)) {
+        fprintf(stderr, "unknown group was loaded\n");
+        gdo_free_lib();
+        return 1;
+    }
+
+    printf("expected error: %s\n", gdo_last_error());
+
+    if (!gdo_load_group_hello() || !gdo_load_symbol(GDO_LOAD_helloworld_callback)) {
+        fprintf(stderr, "%s\n", gdo_last_error());
+        gdo_free_lib();
+        return 1;
+    }
+
+    /* our code */
+    helloworld *hw = helloworld_init();
+    helloworld_callback = cb;
+    helloworld_hello(hw);
+    helloworld_hello2(hw, cb);
+    helloworld_release(hw);
+
+    /* all groups are reset */
+    gdo_free_lib();
+
+    if (gdo_group_loaded_hello() || gdo_group_loaded_lifetime()) {
+        fprintf(stderr, "groups still loaded after free\n");
+        return 1;
+    }
+
+    return 0;
+}
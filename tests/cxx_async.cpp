@@ -0,0 +1,50 @@
+#include <iostream>
+#include "helloworld.h"
+
+/* load the library on a background thread */
+#define GDO_ENABLE_ASYNC_LOADING 1
+
+/* use wrap functions that will wait for a pending load */
+#define GDO_WRAP_FUNCTIONS 1
+
+/* include generated header file */
+#include "cxx_async.hpp"
+
+
+void cb(const char *msg)
+{
+    std::cout << msg << std::endl;
+}
+
+int main()
+{
+    gdo::dl loader;
+
+    /* errors from the background thread are passed to the waiting thread */
+    auto fut = loader.load_async(gdo::make_libname("nonexistent", 0));
+
+    if (fut.get() || gdo::dl::wait_loaded() || loader.error().find("nonexistent") == std::string::npos) {
+        std::cerr << "loading a nonexistent library didn't fail" << std::endl;
+        return 1;
+    }
+
+    std::cout << "expected error: " << loader.error() << std::endl;
+
+    /* load library and symbols */
+    fut = loader.load_async(gdo::make_libname("helloworld", 0));
+
+    /* wrapper functions wait for the pending load */
+    helloworld *hw = helloworld_init();
+
+    if (fut.wait_for(std::chrono::seconds(1)) != std::future_status::ready || !fut.get()) {
+        std::cerr << loader.error() << std::endl;
+        return 1;
+    }
+
+    /* objects may only be used after waiting */
+    helloworld_callback = cb;
+    helloworld_hello(hw);
+    helloworld_release(hw);
+
+    return 0;
+}
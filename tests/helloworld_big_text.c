@@ -0,0 +1,13 @@
+/* 4 MB of code aligned to 2 MB, the usual size of a huge page; linked into
+ * a copy of the helloworld library to test GDO_REMAP_HUGE_TEXT */
+
+#if defined(__GNUC__) && defined(__ELF__)
+__asm__ (
+    ".text\n"
+    ".p2align 21\n"
+    ".fill 0x400000, 1, 0\n"
+);
+#else
+/* ISO C forbids an empty translation unit */
+typedef int helloworld_big_text_unused;
+#endif